@@ -0,0 +1,380 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_ASYNC_H_
+#define FORMATTING_ASYNC_H_
+
+#include <formatting/deferred.hpp>
+
+#ifdef FMTG_USE_CXX11
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace formatting
+{
+	/** What producers of @ref async_sink do when the queue is full. */
+	enum overflow_policy
+	{
+		/** Wait until the consumer frees a slot. */
+		block_on_overflow,
+		/** Drop the message and count it, see @ref async_sink::dropped. */
+		drop_on_overflow,
+		/** Put the message into a list that grows without bound. */
+		grow_on_overflow
+	};
+
+	/** Sink that takes formatting out of producer threads: messages 
+	 * are enqueued into a bounded multi-producer ring and a background 
+	 * thread renders deferred records, batches the text and passes 
+	 * it to the writer.
+	 *
+	 * Producers claim slots of the ring with a compare-and-swap and 
+	 * never lock, except for the overflow list of @ref grow_on_overflow.
+	 * Messages of one producer are written in order they are enqueued.
+	 *
+	 * E.g.
+	 * 	formatting::async_sink sink(stderr);
+	 * 	sink.format("{} took {} ms\n", "request", 12);
+	 * 	static const formatting::deferred_format line("{} took {} ms\n");
+	 * 	sink.capture(line, "request", 12); // formatted by the consumer
+	 */
+	class async_sink
+	{
+	public:
+		typedef std::function<void (const char*, std::size_t)> writer;
+
+		/** Inline capacity of the slot, longer messages are allocated. */
+		static const std::size_t slot_size = 256;
+
+		/** Creates the sink and starts its consumer thread.
+		 *
+		 * @param write the function that takes batches of the text
+		 * @param capacity the number of slots, rounded up to a power of two
+		 * @param policy what to do when all slots are taken
+		 */
+		async_sink(const writer& write, std::size_t capacity = 4096,
+		           overflow_policy policy = block_on_overflow) :
+			write_(write), policy_(policy), mask_(roundCapacity(capacity) - 1),
+			slots_(new slot[mask_ + 1]), tail_(0), overflowed_(0), dropped_(0),
+			head_(0), written_(0), overflow_written_(0), running_(true)
+		{
+			for (std::size_t i=0; i<=mask_; i++)
+				slots_[i].sequence_.store(i, std::memory_order_relaxed);
+			consumer_ = std::thread(&async_sink::consume, this);
+		}
+		/** Creates the sink that writes to the file and flushes 
+		 * it after every batch. The file is not closed. */
+		explicit async_sink(FILE* file, std::size_t capacity = 4096,
+		                    overflow_policy policy = block_on_overflow) :
+			async_sink([file](const char* data, std::size_t length)
+			{
+				fwrite(data, 1, length, file);
+				fflush(file);
+			}, capacity, policy)
+		{
+		}
+		/** Writes the messages left and stops the consumer thread. */
+		~async_sink()
+		{
+			running_.store(false, std::memory_order_release);
+			consumer_.join();
+			delete[] slots_;
+		}
+
+		/** Enqueues the text as it is.
+		 *
+		 * @return false if the message was dropped
+		 */
+		FMTG_INLINE bool write(const char* data, std::size_t length)
+		{
+			return push(false, [data, length](buffer& out)
+			{
+				out.append(data, data + length);
+			});
+		}
+		FMTG_INLINE bool write(const std::string& text)
+		{
+			return write(text.data(), text.length());
+		}
+		/** Formats the arguments in the calling thread straight into 
+		 * the slot, the consumer only copies the text.
+		 *
+		 * @return false if the message was dropped
+		 * @throw formatting_error in case the arguments don't match the
+		 *        placeholders and ErrorPolicy is @ref throw_errors, 
+		 *        nothing is enqueued then
+		 */
+		template <typename ErrorPolicy = throw_errors, typename... Args>
+		FMTG_INLINE bool format(const internal::format_string& fmt, const Args&... args)
+		{
+			return push(false, [&fmt, &args...](buffer& out)
+			{
+				ErrorPolicy report;
+				internal::formatVariadic(out, fmt, report, args...);
+			});
+		}
+		/** Captures the arguments into the slot, they are formatted by
+		 * the consumer. Formatting errors are marked like by
+		 * @ref mark_errors, as nothing can be thrown to the producer.
+		 *
+		 * @return false if the message was dropped
+		 */
+		template <typename... Args>
+		FMTG_INLINE bool capture(const deferred_format& line, const Args&... args)
+		{
+			return push(true, [&line, &args...](buffer& out)
+			{
+				line.capture(out, args...);
+			});
+		}
+		/** Waits until the messages enqueued before are written. */
+		FMTG_INLINE void flush()
+		{
+			const std::size_t position = tail_.load(std::memory_order_acquire);
+			const std::size_t overflowed = overflowed_.load(std::memory_order_acquire);
+			while (written_.load(std::memory_order_acquire) < position ||
+			       overflow_written_.load(std::memory_order_acquire) < overflowed)
+				std::this_thread::yield();
+		}
+		/** Returns the number of messages dropped so far. */
+		FMTG_INLINE std::size_t dropped() const
+		{
+			return dropped_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		async_sink(const async_sink&);
+		async_sink& operator=(const async_sink&);
+
+		struct slot
+		{
+			/** Position the slot is free for or, once written, the
+			 * position plus one, as in Vyukov's bounded queue. */
+			std::atomic<std::size_t> sequence_;
+			bool record_;
+			basic_memory_buffer<slot_size> data_;
+		};
+		struct overflowed_message
+		{
+			bool record_;
+			std::string data_;
+		};
+
+		static std::size_t roundCapacity(std::size_t capacity)
+		{
+			std::size_t rounded = 2;
+			while (rounded < capacity)
+				rounded *= 2;
+			return rounded;
+		}
+
+		/** Returns the claimed slot or NULL if all slots are taken. */
+		FMTG_INLINE slot* claim()
+		{
+			std::size_t position = tail_.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				slot* claimed = &slots_[position & mask_];
+				const std::size_t sequence = claimed->sequence_.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = 
+					static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+				if (difference == 0)
+				{
+					if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						return claimed;
+				}
+				else if (difference < 0)
+					return NULL;
+				else
+					position = tail_.load(std::memory_order_relaxed);
+			}
+		}
+
+		template <typename Fill>
+		FMTG_INLINE bool push(bool record, const Fill& fill)
+		{
+			// once messages went to the overflow list, the following
+			// ones follow them there to keep the order of producers
+			slot* claimed = NULL;
+			if (policy_ != grow_on_overflow || !hasOverflow())
+			{
+				claimed = claim();
+				while (claimed == NULL && policy_ == block_on_overflow)
+				{
+					std::this_thread::yield();
+					claimed = claim();
+				}
+			}
+			if (claimed != NULL)
+			{
+				claimed->record_ = record;
+				claimed->data_.clear();
+				try
+				{
+					fill(claimed->data_);
+				}
+				catch (...)
+				{
+					// the claimed slot has to be published anyway, empty
+					// and as text, so that the consumer skips it
+					claimed->record_ = false;
+					claimed->data_.clear();
+					publish(claimed);
+					throw;
+				}
+				publish(claimed);
+				return true;
+			}
+			if (policy_ == drop_on_overflow)
+			{
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			basic_memory_buffer<slot_size> data;
+			fill(data);
+			overflowed_message message = {record, data.str()};
+			std::lock_guard<std::mutex> lock(overflow_mutex_);
+			overflow_.push_back(message);
+			overflowed_.fetch_add(1, std::memory_order_release);
+			return true;
+		}
+		FMTG_INLINE void publish(slot* claimed)
+		{
+			const std::size_t position = claimed->sequence_.load(std::memory_order_relaxed);
+			claimed->sequence_.store(position + 1, std::memory_order_release);
+		}
+		FMTG_INLINE bool hasOverflow() const
+		{
+			return overflowed_.load(std::memory_order_acquire) != overflow_written_.load(std::memory_order_acquire);
+		}
+
+		/** Moves the written messages into the batch and returns 
+		 * the number of them. */
+		FMTG_INLINE std::size_t takeSlots(basic_memory_buffer<slot_size>& batch, std::size_t batch_size)
+		{
+			std::size_t taken = 0;
+			while (batch.size() < batch_size)
+			{
+				slot& next = slots_[head_ & mask_];
+				if (next.sequence_.load(std::memory_order_acquire) != head_ + 1)
+					break;
+				if (next.record_)
+					render<mark_errors>(batch, next.data_.data());
+				else
+					batch.append(next.data_.begin(), next.data_.end());
+				next.sequence_.store(head_ + mask_ + 1, std::memory_order_release);
+				head_++;
+				taken++;
+			}
+			return taken;
+		}
+		/** Moves the overflowed messages into the batch once every
+		 * claimed slot is read and returns the number of them. Slots
+		 * claimed before a message overflowed hold earlier messages of
+		 * its producer, so they have to be written first. The position
+		 * is read under the lock to see every claim made before the
+		 * messages were put into the list. */
+		FMTG_INLINE std::size_t takeOverflow(basic_memory_buffer<slot_size>& batch)
+		{
+			std::deque<overflowed_message> messages;
+			{
+				std::lock_guard<std::mutex> lock(overflow_mutex_);
+				if (tail_.load(std::memory_order_relaxed) != head_)
+					return 0;
+				messages.swap(overflow_);
+			}
+			for (std::size_t i=0; i<messages.size(); i++)
+			{
+				const std::string& data = messages[i].data_;
+				if (messages[i].record_)
+					render<mark_errors>(batch, data.data());
+				else
+					batch.append(data);
+			}
+			return messages.size();
+		}
+		/** Loop of the consumer thread. */
+		void consume()
+		{
+			static const std::size_t batch_size = 64 * 1024;
+			basic_memory_buffer<slot_size> batch;
+			std::size_t idle = 0;
+			for (;;)
+			{
+				const bool running = running_.load(std::memory_order_acquire);
+				batch.clear();
+				const std::size_t taken = takeSlots(batch, batch_size);
+				const std::size_t taken_overflow = hasOverflow() ? takeOverflow(batch) : 0;
+				if (batch.size() != 0)
+					write_(batch.data(), batch.size());
+				written_.store(head_, std::memory_order_release);
+				if (taken_overflow != 0)
+					overflow_written_.fetch_add(taken_overflow, std::memory_order_release);
+				if (taken != 0 || taken_overflow != 0)
+					idle = 0;
+				else if (!running)
+					break;
+				else if (++idle < 64)
+					std::this_thread::yield();
+				else
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+		}
+
+		writer write_;
+		const overflow_policy policy_;
+		const std::size_t mask_;
+		slot* slots_;
+		/* Counters written by producers and the ones written by the
+		 * consumer are on separate cache lines, so that claiming a
+		 * slot doesn't invalidate the line the consumer updates. */
+		/** Position of the next slot to claim. */
+		alignas(64) std::atomic<std::size_t> tail_;
+		std::atomic<std::size_t> overflowed_;
+		std::atomic<std::size_t> dropped_;
+		/** Position of the next slot to read, used by the consumer only. */
+		alignas(64) std::size_t head_;
+		std::atomic<std::size_t> written_;
+		std::atomic<std::size_t> overflow_written_;
+		std::atomic<bool> running_;
+		std::mutex overflow_mutex_;
+		std::deque<overflowed_message> overflow_;
+		std::thread consumer_;
+	};
+}
+
+#endif
+#endif
@@ -0,0 +1,337 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FORMATTING_BUFFER_H_
+#define FORMATTING_BUFFER_H_
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+
+namespace formatting
+{
+	namespace internal
+	{
+		/** Contiguous storage that representations are written to.
+		 * Derived buffers provide the storage and make room on
+		 * demand in @ref buffer::grow, either by reallocating the
+		 * storage or by flushing its content somewhere else. */
+		class buffer
+		{
+		public:
+			FMTG_INLINE void append(const char* begin, const char* end)
+			{
+				while (begin != end)
+				{
+					if (size_ == capacity_)
+						grow(size_ + (end - begin));
+					const std::size_t count = std::min(static_cast<std::size_t>(end - begin), capacity_ - size_);
+					std::memcpy(ptr_ + size_, begin, count);
+					size_ += count;
+					begin += count;
+				}
+			}
+			FMTG_INLINE void append(const std::string& value)
+			{
+				append(value.data(), value.data() + value.length());
+			}
+			FMTG_INLINE void push_back(char value)
+			{
+				if (size_ == capacity_)
+					grow(size_ + 1);
+				ptr_[size_++] = value;
+			}
+			/** Makes room for n more characters if the storage can grow. */
+			FMTG_INLINE void reserve(std::size_t n)
+			{
+				if (size_ + n > capacity_)
+					grow(size_ + n);
+			}
+			/** Returns the pointer to n characters that can be written
+			 * directly and then committed with @ref buffer::commit, or
+			 * NULL if the buffer can't provide them contiguously. */
+			FMTG_INLINE char* reserveContiguous(std::size_t n)
+			{
+				if (size_ + n > capacity_)
+					grow(size_ + n);
+				return size_ + n <= capacity_ ? ptr_ + size_ : NULL;
+			}
+			FMTG_INLINE void commit(std::size_t n)
+			{
+				size_ += n;
+			}
+			/** Appends a copy of length characters that were written
+			 * starting from position (as returned by @ref buffer::written).
+			 *
+			 * @return false if the characters were already flushed
+			 *         and nothing was appended
+			 */
+			FMTG_INLINE bool repeat(std::size_t position, std::size_t length)
+			{
+				reserve(length);
+				if (position < flushed_ || size_ + length > capacity_)
+					return false;
+				std::memcpy(ptr_ + size_, ptr_ + (position - flushed_), length);
+				size_ += length;
+				return true;
+			}
+			/** Returns the number of characters written so far,
+			 * including the flushed ones. */
+			FMTG_INLINE std::size_t written() const
+			{
+				return flushed_ + size_;
+			}
+		protected:
+			buffer(char* ptr, std::size_t size, std::size_t capacity) :
+				ptr_(ptr), size_(size), capacity_(capacity), flushed_(0)
+			{
+			}
+			virtual ~buffer() { }
+			/** Provides the capacity of at least n characters if possible.
+			 * Buffers that can't grow flush the content instead once
+			 * they are full. */
+			virtual void grow(std::size_t n) = 0;
+
+			char* ptr_;
+			std::size_t size_;
+			std::size_t capacity_;
+			std::size_t flushed_;
+		private:
+			buffer(const buffer&);
+			buffer& operator=(const buffer&);
+		};
+
+		/** Buffer that appends to a string. The string is
+		 * resized to the written length by @ref basic_string_buffer::finish. */
+		template <typename String>
+		class basic_string_buffer : public buffer
+		{
+		public:
+			explicit basic_string_buffer(String& target) :
+				buffer(NULL, target.length(), target.length()), target_(target)
+			{
+				if (!target_.empty())
+					ptr_ = &target_[0];
+			}
+			FMTG_INLINE void finish()
+			{
+				target_.resize(size_);
+			}
+		protected:
+			virtual void grow(std::size_t n)
+			{
+				const std::size_t capacity = std::max(n, capacity_ + capacity_/2);
+				target_.resize(capacity);
+				ptr_ = &target_[0];
+				capacity_ = capacity;
+			}
+		private:
+			String& target_;
+		};
+		typedef basic_string_buffer<std::string> string_buffer;
+
+		/** Buffer that writes to an output iterator by chunks. */
+		template <typename OutputIt>
+		class iterator_buffer : public buffer
+		{
+		public:
+			explicit iterator_buffer(OutputIt out) :
+				buffer(chunk_, 0, sizeof(chunk_)), out_(out)
+			{
+			}
+			FMTG_INLINE OutputIt out()
+			{
+				flush();
+				return out_;
+			}
+		protected:
+			virtual void grow(std::size_t)
+			{
+				flush();
+			}
+		private:
+			FMTG_INLINE void flush()
+			{
+				out_ = std::copy(ptr_, ptr_ + size_, out_);
+				flushed_ += size_;
+				size_ = 0;
+			}
+
+			OutputIt out_;
+			char chunk_[256];
+		};
+
+		/** Buffer that writes straight to the memory pointed by char*. */
+		template <>
+		class iterator_buffer<char*> : public buffer
+		{
+		public:
+			explicit iterator_buffer(char* out) :
+				buffer(out, 0, static_cast<std::size_t>(-1))
+			{
+			}
+			FMTG_INLINE char* out()
+			{
+				return ptr_ + size_;
+			}
+		protected:
+			virtual void grow(std::size_t)
+			{
+			}
+		};
+
+		/** Buffer that writes up to the capacity of the provided
+		 * memory and only counts the rest. */
+		class truncating_buffer : public buffer
+		{
+		public:
+			truncating_buffer(char* out, std::size_t capacity) :
+				buffer(out, 0, capacity)
+			{
+				if (capacity_ == 0)
+					grow(0);
+			}
+		protected:
+			virtual void grow(std::size_t)
+			{
+				if (size_ < capacity_)
+					return;
+				flushed_ += size_;
+				size_ = 0;
+				ptr_ = discarded_;
+				capacity_ = sizeof(discarded_);
+			}
+		private:
+			char discarded_[128];
+		};
+
+		/** Buffer that only counts written characters. */
+		class counting_buffer : public truncating_buffer
+		{
+		public:
+			counting_buffer() :
+				truncating_buffer(NULL, 0)
+			{
+			}
+		};
+	}
+
+	/** The output that representations are appended to,
+	 * e.g. by @ref formatter specializations. */
+	typedef internal::buffer buffer;
+
+	/** A buffer to format to that keeps up to N characters
+	 * in the inline storage and moves to the heap only when
+	 * it is exceeded. Clearing keeps the storage, so an
+	 * instance reused for many lines stops allocating once
+	 * it has grown to the longest line.
+	 *
+	 * E.g. to format lines with no steady-state allocations
+	 * 	thread_local formatting::memory_buffer line;
+	 * 	line.clear();
+	 * 	formatting::format_to(line, "{} is {}", "x", 42);
+	 * 	fwrite(line.data(), 1, line.size(), stderr);
+	 */
+	template <std::size_t N, typename Allocator = std::allocator<char> >
+	class basic_memory_buffer : public internal::buffer
+	{
+	public:
+		/** @param allocator the allocator of the storage that
+		 *        doesn't fit the inline one, e.g. an arena */
+		explicit basic_memory_buffer(const Allocator& allocator = Allocator()) :
+			buffer(store_, 0, N), allocator_(allocator)
+		{
+		}
+		~basic_memory_buffer()
+		{
+			if (ptr_ != store_)
+				allocator_.deallocate(ptr_, capacity_);
+		}
+		FMTG_INLINE char* data()
+		{
+			return ptr_;
+		}
+		FMTG_INLINE const char* data() const
+		{
+			return ptr_;
+		}
+		FMTG_INLINE std::size_t size() const
+		{
+			return size_;
+		}
+		FMTG_INLINE std::size_t capacity() const
+		{
+			return capacity_;
+		}
+		FMTG_INLINE const char* begin() const
+		{
+			return ptr_;
+		}
+		FMTG_INLINE const char* end() const
+		{
+			return ptr_ + size_;
+		}
+		/** Forgets the content and keeps the storage. */
+		FMTG_INLINE void clear()
+		{
+			size_ = 0;
+		}
+		/** Returns the null-terminated content. */
+		FMTG_INLINE const char* c_str()
+		{
+			push_back('\0');
+			size_--;
+			return ptr_;
+		}
+		FMTG_INLINE std::string str() const
+		{
+			return std::string(ptr_, size_);
+		}
+	protected:
+		virtual void grow(std::size_t n)
+		{
+			const std::size_t capacity = std::max(n, capacity_ + capacity_/2);
+			char* ptr = allocator_.allocate(capacity);
+			std::memcpy(ptr, ptr_, size_);
+			if (ptr_ != store_)
+				allocator_.deallocate(ptr_, capacity_);
+			ptr_ = ptr;
+			capacity_ = capacity;
+		}
+	private:
+		Allocator allocator_;
+		char store_[N];
+	};
+
+	/** The memory buffer with the inline storage that fits
+	 * a typical log line. */
+	typedef basic_memory_buffer<500> memory_buffer;
+}
+#endif
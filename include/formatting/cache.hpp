@@ -0,0 +1,378 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_CACHE_H_
+#define FORMATTING_CACHE_H_
+
+#ifdef FMTG_USE_CXX11
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/** Number of formats the cache keeps, a power of two. */
+#ifndef FMTG_FORMAT_CACHE_SIZE
+	#define FMTG_FORMAT_CACHE_SIZE 256
+#endif
+
+namespace formatting
+{
+	/** Counters of the format cache, see @ref format_cache_stats. */
+	struct format_cache_statistics
+	{
+		std::size_t hits_;
+		std::size_t misses_;
+		std::size_t evictions_;
+	};
+
+	namespace internal
+	{
+		FMTG_INLINE unsigned long long mixWord(unsigned long long hash, const char* data)
+		{
+			unsigned long long word;
+			std::memcpy(&word, data, 8);
+			hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+			return hash ^ (hash >> 32);
+		}
+		/** Hashes short strings whole and long ones by their ends and
+		 * evenly spread samples, so that the time doesn't grow with
+		 * the length. Matches are compared whole anyway. */
+		FMTG_INLINE std::size_t hashCharacters(const char* data, std::size_t length)
+		{
+			static const std::size_t whole_length = 128;
+			static const std::size_t n_samples = 16;
+			unsigned long long hash = 0x9E3779B97F4A7C15ull ^ length;
+			if (length <= whole_length)
+			{
+				const char* end = data + length;
+				for (; end - data >= 8; data += 8)
+					hash = mixWord(hash, data);
+				unsigned long long tail = 0;
+				std::memcpy(&tail, data, end - data);
+				hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+			}
+			else
+			{
+				for (std::size_t i=0; i<whole_length/2; i+=8)
+					hash = mixWord(mixWord(hash, data + i), data + length - 8 - i);
+				const std::size_t stride = (length - whole_length) / n_samples;
+				for (std::size_t i=0; i<n_samples; i++)
+					hash = mixWord(hash, data + whole_length/2 + i * stride);
+			}
+			return static_cast<std::size_t>(hash ^ (hash >> 29));
+		}
+
+		/** Switch of the format cache, a template to be defined in
+		 * the header. It is apart from the cache, so that disabled
+		 * calls don't check whether the cache is constructed. */
+		template <typename T = void>
+		struct format_cache_state
+		{
+			static std::atomic<bool> enabled_;
+		};
+		template <typename T>
+		std::atomic<bool> format_cache_state<T>::enabled_(false);
+
+		/** Parsed formats of formatting strings seen at runtime.
+		 *
+		 * Formats are looked up by the hash of the string in a
+		 * direct-mapped table of atomic pointers, a new format evicts
+		 * the one of its slot. Lookups take no locks: a reader
+		 * publishes the format it uses in its hazard pointer, and
+		 * evicted formats are deleted once no hazard pointer refers
+		 * to them. A reader has a stack of hazard pointers, as an
+		 * argument may format with the cache while it is written.
+		 * Counters are kept per thread as well, so that readers share
+		 * no written cache lines.
+		 */
+		class format_cache
+		{
+		public:
+			struct entry
+			{
+				entry(std::size_t hash, const char* data, std::size_t length) :
+					hash_(hash), parsed_(std::string(data, length))
+				{
+				}
+				FMTG_INLINE bool matches(std::size_t hash, const char* data, std::size_t length) const
+				{
+					return hash_ == hash && parsed_.source().length() == length &&
+						std::memcmp(parsed_.source().data(), data, length) == 0;
+				}
+				std::size_t hash_;
+				parsed_format parsed_;
+			};
+
+			/** Formats of nested calls that a thread uses at once,
+			 * deeper calls don't use the cache. */
+			static const std::size_t max_depth = 4;
+			/** State of a thread that uses the cache. */
+			struct reader
+			{
+				std::atomic<bool> used_;
+				/** Hazard pointers of the calls in progress, the first
+				 * depth_ of them are in use. */
+				std::atomic<const entry*> hazards_[max_depth];
+				std::size_t depth_;
+				std::atomic<std::size_t> hits_;
+				std::atomic<std::size_t> misses_;
+				char padding_[64];
+			};
+			static const std::size_t max_readers = 128;
+			static const std::size_t table_size = FMTG_FORMAT_CACHE_SIZE;
+			static_assert(table_size > 0 && (table_size & (table_size - 1)) == 0,
+				"FMTG_FORMAT_CACHE_SIZE must be a power of two");
+
+			static format_cache& instance()
+			{
+				static format_cache cache;
+				return cache;
+			}
+			~format_cache()
+			{
+				for (std::size_t i=0; i<table_size; i++)
+					delete table_[i].load(std::memory_order_relaxed);
+				for (std::size_t i=0; i<retired_.size(); i++)
+					delete retired_[i];
+			}
+
+			static FMTG_INLINE bool enabled()
+			{
+				return format_cache_state<>::enabled_.load(std::memory_order_relaxed);
+			}
+			static FMTG_INLINE void enable(bool enabled)
+			{
+				format_cache_state<>::enabled_.store(enabled, std::memory_order_relaxed);
+			}
+
+			/** Returns the reader of the calling thread or NULL if
+			 * too many threads use the cache. */
+			FMTG_INLINE reader* currentReader()
+			{
+				thread_local reader_holder holder;
+				if (holder.reader_ == NULL && !holder.tried_)
+				{
+					holder.tried_ = true;
+					for (std::size_t i=0; i<max_readers && holder.reader_ == NULL; i++)
+					{
+						bool used = false;
+						if (readers_[i].used_.compare_exchange_strong(used, true))
+							holder.reader_ = &readers_[i];
+					}
+				}
+				return holder.reader_;
+			}
+
+			/** Returns the format of the string, parsed now if it is
+			 * not cached. The format is protected by the next hazard
+			 * pointer of the reader until @ref release, the reader
+			 * must have less than max_depth formats acquired. The
+			 * pointer is taken before parsing, so @ref release is
+			 * due even if parsing throws. */
+			FMTG_INLINE const entry* acquire(reader& current, const char* data, std::size_t length)
+			{
+				const std::size_t hash = hashCharacters(data, length);
+				std::atomic<entry*>& slot = table_[hash & (table_size - 1)];
+				std::atomic<const entry*>& hazard = current.hazards_[current.depth_++];
+				const entry* found = slot.load(std::memory_order_acquire);
+				for (;;)
+				{
+					hazard.store(found, std::memory_order_seq_cst);
+					const entry* again = slot.load(std::memory_order_acquire);
+					if (again == found)
+						break;
+					found = again;
+				}
+				if (found != NULL && found->matches(hash, data, length))
+				{
+					increment(current.hits_);
+					return found;
+				}
+				increment(current.misses_);
+				entry* parsed = new entry(hash, data, length);
+				hazard.store(parsed, std::memory_order_seq_cst);
+				entry* evicted = slot.exchange(parsed, std::memory_order_acq_rel);
+				if (evicted != NULL)
+					retire(evicted);
+				return parsed;
+			}
+			/** Releases the format acquired last. */
+			FMTG_INLINE void release(reader& current)
+			{
+				current.hazards_[--current.depth_].store(NULL, std::memory_order_release);
+			}
+
+			FMTG_INLINE format_cache_statistics statistics()
+			{
+				format_cache_statistics counters = {0, 0, 0};
+				for (std::size_t i=0; i<max_readers; i++)
+				{
+					counters.hits_ += readers_[i].hits_.load(std::memory_order_relaxed);
+					counters.misses_ += readers_[i].misses_.load(std::memory_order_relaxed);
+				}
+				counters.evictions_ = evictions_.load(std::memory_order_relaxed);
+				return counters;
+			}
+			/** Evicts all formats. */
+			FMTG_INLINE void clear()
+			{
+				for (std::size_t i=0; i<table_size; i++)
+				{
+					entry* evicted = table_[i].exchange(NULL, std::memory_order_acq_rel);
+					if (evicted != NULL)
+						retire(evicted);
+				}
+			}
+
+		private:
+			format_cache() :
+				evictions_(0)
+			{
+				for (std::size_t i=0; i<table_size; i++)
+					table_[i].store(NULL, std::memory_order_relaxed);
+				for (std::size_t i=0; i<max_readers; i++)
+				{
+					readers_[i].used_.store(false, std::memory_order_relaxed);
+					for (std::size_t j=0; j<max_depth; j++)
+						readers_[i].hazards_[j].store(NULL, std::memory_order_relaxed);
+					readers_[i].depth_ = 0;
+					readers_[i].hits_.store(0, std::memory_order_relaxed);
+					readers_[i].misses_.store(0, std::memory_order_relaxed);
+				}
+			}
+			format_cache(const format_cache&);
+			format_cache& operator=(const format_cache&);
+
+			/** Gives the reader back when its thread exits, the
+			 * counters are kept. */
+			struct reader_holder
+			{
+				reader_holder() : reader_(NULL), tried_(false) { }
+				~reader_holder()
+				{
+					if (reader_ != NULL)
+						reader_->used_.store(false, std::memory_order_release);
+				}
+				reader* reader_;
+				bool tried_;
+			};
+
+			/** Only the thread of the reader writes its counters. */
+			static FMTG_INLINE void increment(std::atomic<std::size_t>& counter)
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+
+			/** Deletes the evicted format once no reader uses it. */
+			FMTG_INLINE void retire(entry* evicted)
+			{
+				evictions_.fetch_add(1, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> lock(retired_mutex_);
+				retired_.push_back(evicted);
+				if (retired_.size() < 2 * max_readers)
+					return;
+				std::vector<const entry*> hazards;
+				for (std::size_t i=0; i<max_readers; i++)
+				{
+					for (std::size_t j=0; j<max_depth; j++)
+					{
+						const entry* hazard = readers_[i].hazards_[j].load(std::memory_order_seq_cst);
+						if (hazard != NULL)
+							hazards.push_back(hazard);
+					}
+				}
+				std::vector<entry*> kept;
+				for (std::size_t i=0; i<retired_.size(); i++)
+				{
+					if (std::find(hazards.begin(), hazards.end(), retired_[i]) == hazards.end())
+						delete retired_[i];
+					else
+						kept.push_back(retired_[i]);
+				}
+				retired_.swap(kept);
+			}
+
+			std::atomic<entry*> table_[table_size];
+			reader readers_[max_readers];
+			std::atomic<std::size_t> evictions_;
+			std::mutex retired_mutex_;
+			std::vector<entry*> retired_;
+		};
+
+		/** Formats with the cached format of the string, returns
+		 * false if the cache is disabled or can't be used by the
+		 * thread. */
+		template <typename ErrorPolicy, typename Arguments>
+		FMTG_INLINE bool formatCached(buffer& formatted, const char* formatter, std::size_t length,
+		                              const Arguments& arguments, rendered* outputs, ErrorPolicy& report)
+		{
+			if (!format_cache::enabled())
+				return false;
+			format_cache& cache = format_cache::instance();
+			format_cache::reader* current = cache.currentReader();
+			if (current == NULL || current->depth_ == format_cache::max_depth)
+				return false;
+			try
+			{
+				const format_cache::entry* cached = cache.acquire(*current, formatter, length);
+				cached->parsed_.applyArguments(formatted, arguments, outputs, report);
+			}
+			catch (...)
+			{
+				cache.release(*current);
+				throw;
+			}
+			cache.release(*current);
+			return true;
+		}
+	}
+
+	/** Makes format functions with runtime formatting strings keep
+	 * parsed formats of the strings, so that repeated strings are
+	 * not scanned again. The cache keeps FMTG_FORMAT_CACHE_SIZE 
+	 * formats, define it before the include to change. */
+	FMTG_INLINE void enable_format_cache(bool enabled = true)
+	{
+		internal::format_cache::enable(enabled);
+	}
+	/** Returns hits, misses and evictions of the format cache. */
+	FMTG_INLINE format_cache_statistics format_cache_stats()
+	{
+		return internal::format_cache::instance().statistics();
+	}
+	/** Evicts all formats of the format cache. */
+	FMTG_INLINE void clear_format_cache()
+	{
+		internal::format_cache::instance().clear();
+	}
+}
+
+#endif
+#endif
@@ -0,0 +1,284 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_COLUMNS_H_
+#define FORMATTING_COLUMNS_H_
+
+#include <formatting/formatting.hpp>
+
+#ifdef FMTG_USE_CXX11
+
+#include <vector>
+
+namespace formatting
+{
+	namespace internal
+	{
+		/** Writes the values of rows of the column one after another
+		 * and stores where each of them ends. Returns false and writes
+		 * nothing if the presentation type of the spec doesn't apply
+		 * to the values. */
+		typedef bool (*column_writer)(buffer& scratch, const void* column, std::size_t n_rows,
+		                              const format_spec* spec, std::size_t* ends);
+
+		template <typename Column>
+		bool writeColumn(buffer& scratch, const void* column, std::size_t n_rows,
+		                 const format_spec* spec, std::size_t* ends)
+		{
+			const Column& values = *static_cast<const Column*>(column);
+			typedef typename decayed<typename unqualified<
+				typename std::remove_reference<decltype(values[0])>::type>::type>::type value_type;
+			if (spec != NULL && !specApplies<value_type>(*spec))
+				return false;
+			if (n_rows == 0)
+				return true;
+			scratch.reserve(n_rows * dispatchImplementation<value_type>().size_hint(values[0]));
+			if (spec == NULL)
+			{
+				for (std::size_t i=0; i<n_rows; i++)
+				{
+					writeArgument(scratch, values[i]);
+					ends[i] = scratch.written();
+				}
+			}
+			else
+			{
+				for (std::size_t i=0; i<n_rows; i++)
+				{
+					writeWithSpec(scratch, values[i], *spec);
+					ends[i] = scratch.written();
+				}
+			}
+			return true;
+		}
+
+		/** Writes to the storage that is known to be large enough,
+		 * short pieces are copied without calls. */
+		struct contiguous_writer
+		{
+			explicit contiguous_writer(char* out) :
+				out_(out)
+			{
+			}
+			FMTG_INLINE void append(const char* data, std::size_t length)
+			{
+				if (length <= 8)
+				{
+					for (std::size_t i=0; i<length; i++)
+						out_[i] = data[i];
+				}
+				else
+					std::memcpy(out_, data, length);
+				out_ += length;
+			}
+			char* out_;
+		};
+
+		/** Column with the writer of its type. */
+		struct column_wrapper
+		{
+			template <typename Column>
+			column_wrapper(const Column& column) :
+				column_(&column), writer_(&writeColumn<Column>)
+			{
+			}
+			column_wrapper() :
+				column_(NULL), writer_(NULL)
+			{
+			}
+			const void* column_;
+			column_writer writer_;
+		};
+
+		/** Formats all rows: every field is written for all rows by
+		 * the writer of its column and then rows are put together 
+		 * from literals and written values. Fields that can't be 
+		 * written and unused columns are reported to the policy once,
+		 * the markers it writes are repeated in every row. */
+		template <typename ErrorPolicy>
+		FMTG_INLINE void formatColumns(buffer& formatted, const format_string& formatter, std::size_t n_rows,
+		                               const column_wrapper* columns, std::size_t n_columns, ErrorPolicy& report)
+		{
+			const parsed_format parsed(std::string(formatter.data(), formatter.length()));
+			const std::size_t n_fields = parsed.n_fields();
+			// field i shows values written for field sources[i], the ones of
+			// field j are in scratch from starts[j] up to ends of its rows
+			basic_memory_buffer<500> scratch;
+			std::vector<std::size_t> ends(n_fields * n_rows);
+			std::vector<std::size_t> starts(n_fields, 0);
+			std::vector<std::size_t> sources(n_fields, 0);
+			// fields that can't be written show [markers[i], markers[i + 1])
+			std::vector<std::size_t> markers(n_fields + 1, 0);
+			std::vector<bool> failed(n_fields, false);
+			basic_memory_buffer<128> marker_text;
+			for (std::size_t i=0; i<n_fields; i++)
+			{
+				const parsed_format::segment& current = parsed.field_at(i);
+				markers[i] = marker_text.size();
+				if (current.invalid_spec_)
+				{
+					failed[i] = true;
+					report(marker_text, invalid_spec, NULL, 0);
+					continue;
+				}
+				if (current.mixed_indexing_)
+				{
+					failed[i] = true;
+					report(marker_text, mixed_indexing, NULL, 0);
+					continue;
+				}
+				if (current.kind_ == field::named || current.begin_ >= n_columns)
+				{
+					failed[i] = true;
+					const bool named = current.kind_ == field::named;
+					report(marker_text, fieldError(current.kind_), 
+					       named ? parsed.source().data() + current.begin_ : NULL, current.length_);
+					continue;
+				}
+				// fields of the same column without specs share the values
+				sources[i] = i;
+				for (std::size_t j=0; j<i && !current.has_spec_ && sources[i] == i; j++)
+				{
+					const parsed_format::segment& previous = parsed.field_at(j);
+					if (!failed[j] && !previous.has_spec_ && previous.begin_ == current.begin_)
+						sources[i] = j;
+				}
+				if (sources[i] != i)
+					continue;
+				starts[i] = scratch.size();
+				const column_wrapper& column = columns[current.begin_];
+				if (!column.writer_(scratch, column.column_, n_rows, current.has_spec_ ? &current.spec_ : NULL, 
+				                    n_rows != 0 ? &ends[i * n_rows] : NULL))
+				{
+					failed[i] = true;
+					report(marker_text, invalid_spec, NULL, 0);
+				}
+			}
+			markers[n_fields] = marker_text.size();
+			if (parsed.automatic_only() && n_fields < n_columns)
+				report(marker_text, unused_arguments, NULL, 0);
+			if (n_rows == 0)
+				return;
+			const char* unused_marker = marker_text.data() + markers[n_fields];
+			const char* markers_end = marker_text.data() + marker_text.size();
+
+			std::size_t values_length = 0;
+			for (std::size_t i=0; i<n_fields; i++)
+			{
+				if (!failed[i])
+					values_length += ends[sources[i] * n_rows + n_rows - 1] - starts[sources[i]];
+			}
+			const std::size_t length = n_rows * (parsed.text_length() + marker_text.size()) + values_length;
+			std::vector<const char*> literals(n_fields + 1);
+			std::vector<std::size_t> literal_lengths(n_fields + 1);
+			for (std::size_t i=0; i<=n_fields; i++)
+				parsed.literal_at(i, literals[i], literal_lengths[i]);
+			// rows are written straight to the storage unless the
+			// buffer can't provide it in one piece
+			char* out = formatted.reserveContiguous(length);
+			contiguous_writer contiguous(out);
+			const auto append = [&](const char* data, std::size_t n)
+			{
+				if (out != NULL)
+					contiguous.append(data, n);
+				else
+					formatted.append(data, data + n);
+			};
+			const char* values = scratch.data();
+			for (std::size_t row=0; row<n_rows; row++)
+			{
+				for (std::size_t i=0; i<n_fields; i++)
+				{
+					append(literals[i], literal_lengths[i]);
+					if (failed[i])
+						append(marker_text.data() + markers[i], markers[i + 1] - markers[i]);
+					else
+					{
+						const std::size_t* source_ends = &ends[sources[i] * n_rows];
+						const std::size_t begin = row == 0 ? starts[sources[i]] : source_ends[row - 1];
+						append(values + begin, source_ends[row] - begin);
+					}
+				}
+				append(literals[n_fields], literal_lengths[n_fields]);
+				append(unused_marker, markers_end - unused_marker);
+			}
+			if (out != NULL)
+				formatted.commit(length);
+		}
+	}
+
+	/** Formats a row for every index of the columns and appends
+	 * the rows to the memory buffer. The formatting string is
+	 * parsed and the type of every column is dispatched once, and
+	 * values of a column are written in a loop of their own.
+	 *
+	 * E.g.
+	 * 	std::vector<int> ids = {1, 2};
+	 * 	std::vector<double> values = {0.5, 1.25};
+	 * 	formatting::format_columns_to(out, "{},{}\n", 2, ids, values);
+	 * 	// => '1,0.5\n2,1.25\n'
+	 *
+	 * @param out the buffer the rows are appended to
+	 * @param fmt the formatting string of a row with {}, indexed and
+	 *        spec fields that refer to columns, named fields are errors
+	 * @param n_rows the number of rows, every column has at least that many values
+	 * @param columns vectors, arrays, pointers or other containers
+	 *        with operator[]
+	 * @throw formatting_error in case the fields don't match the columns 
+	 *        and ErrorPolicy is @ref throw_errors, nothing is appended then
+	 */
+	template <typename ErrorPolicy = throw_errors, std::size_t N, typename Allocator, typename... Columns>
+	FMTG_INLINE void format_columns_to(basic_memory_buffer<N, Allocator>& out, const internal::format_string& fmt,
+	                                   std::size_t n_rows, const Columns&... columns)
+	{
+		const internal::column_wrapper wrappers[] = {internal::column_wrapper(columns)..., 
+			internal::column_wrapper()};
+		ErrorPolicy report;
+		internal::formatColumns(out, fmt, n_rows, wrappers, sizeof...(Columns), report);
+	}
+
+	/** Returns the rows formatted like by @ref format_columns_to. */
+	template <typename ErrorPolicy = throw_errors, typename... Columns>
+	FMTG_INLINE std::string format_columns(const internal::format_string& fmt, std::size_t n_rows, 
+	                                       const Columns&... columns)
+	{
+		std::string formatted;
+		internal::string_buffer buffer(formatted);
+		const internal::column_wrapper wrappers[] = {internal::column_wrapper(columns)..., 
+			internal::column_wrapper()};
+		ErrorPolicy report;
+		internal::formatColumns(buffer, fmt, n_rows, wrappers, sizeof...(Columns), report);
+		buffer.finish();
+		return formatted;
+	}
+}
+
+#endif
+#endif
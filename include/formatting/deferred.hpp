@@ -0,0 +1,724 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_DEFERRED_H_
+#define FORMATTING_DEFERRED_H_
+
+#include <formatting/formatting.hpp>
+
+#ifdef FMTG_USE_CXX11
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+/** Deferred formatting: a call captures the id of the formatting
+ * string and the argument values into a binary record and the text
+ * is rendered later, possibly by another thread or process.
+ *
+ * Records are a kind byte followed by the payload:
+ * - 'E' entry: uint32 id, uint8 number of arguments, captured arguments
+ * - 'T' template: uint32 id, uint32 length, characters of the string
+ *
+ * Captured values start with a tag: 'i' long long, 'u' unsigned long
+ * long, 'f' float, 'd' double, 'L' long double, 'b' bool, 'c' char,
+ * 's' string and 't' text (uint32 length, characters), 'r' range (open
+ * and close characters, uint32 count, elements), 'k' key and value,
+ * 'n' name (uint32 length, characters with the null one, value).
+ * Values are stored in the native byte order. Types that have no
+ * tag are converted to text while captured.
+ */
+
+namespace formatting
+{
+	namespace internal
+	{
+		static const char entry_record = 'E';
+		static const char template_record = 'T';
+
+		/** Formatting strings of deferred formats by their ids. */
+		class template_registry
+		{
+		public:
+			static template_registry& instance()
+			{
+				static template_registry registry;
+				return registry;
+			}
+			FMTG_INLINE std::uint32_t add(const std::string& formatter)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				templates_.push_back(formatter);
+				return static_cast<std::uint32_t>(templates_.size() - 1);
+			}
+			/** Returns the formatting string or NULL if the id is not known. */
+			FMTG_INLINE const std::string* find(std::uint32_t id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				return id < templates_.size() ? &templates_[id] : NULL;
+			}
+			FMTG_INLINE std::size_t size()
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				return templates_.size();
+			}
+		private:
+			std::mutex mutex_;
+			/** Deque keeps the strings in place while it grows. */
+			std::deque<std::string> templates_;
+		};
+
+		template <typename T>
+		FMTG_INLINE void appendRaw(buffer& out, const T& value)
+		{
+			char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			out.append(bytes, bytes + sizeof(T));
+		}
+		/** x87 extended precision values have 10 significant bytes
+		 * and the padding after them is not initialized, it is
+		 * written as zeros so that records of equal values are the
+		 * same. */
+		FMTG_INLINE void appendRaw(buffer& out, long double value)
+		{
+			char bytes[sizeof(long double)] = {};
+			const std::size_t significant = 
+				std::numeric_limits<long double>::digits == 64 ? 10 : sizeof(long double);
+			std::memcpy(bytes, &value, significant);
+			out.append(bytes, bytes + sizeof(long double));
+		}
+		template <typename T>
+		FMTG_INLINE T readRaw(const char*& p)
+		{
+			T value;
+			std::memcpy(&value, p, sizeof(T));
+			p += sizeof(T);
+			return value;
+		}
+		FMTG_INLINE void appendCharacters(buffer& out, char tag, const char* data, std::size_t length)
+		{
+			out.push_back(tag);
+			appendRaw(out, static_cast<std::uint32_t>(length));
+			out.append(data, data + length);
+		}
+
+		template <typename T>
+		FMTG_INLINE void captureValue(buffer& out, const T& value);
+
+		namespace
+		{
+			/** Captures the text of types that have no tag. */
+			template <typename T, int category = specCategory<T>::value>
+			struct captureImplementation
+			{
+				FMTG_INLINE void operator()(buffer& out, const T& value) const
+				{
+					basic_memory_buffer<128> text;
+					writeArgument(text, value);
+					appendCharacters(out, 't', text.data(), text.size());
+				}
+			};
+			template <typename T>
+			struct captureImplementation<T, integer_spec>
+			{
+				FMTG_INLINE void operator()(buffer& out, const T& value) const
+				{
+					if (std::numeric_limits<T>::is_signed)
+					{
+						out.push_back('i');
+						appendRaw(out, static_cast<long long>(value));
+					}
+					else
+					{
+						out.push_back('u');
+						appendRaw(out, static_cast<unsigned long long>(value));
+					}
+				}
+			};
+			template <typename T>
+			struct captureImplementation<T, floating_spec>
+			{
+				FMTG_INLINE void operator()(buffer& out, const T& value) const
+				{
+					out.push_back(is_same<T, float>::value ? 'f' : is_same<T, double>::value ? 'd' : 'L');
+					appendRaw(out, value);
+				}
+			};
+			template <typename T>
+			struct captureImplementation<T, string_spec>
+			{
+				FMTG_INLINE void operator()(buffer& out, const T& value) const
+				{
+					const char* data;
+					std::size_t length;
+					getCharacters(value, data, length);
+					appendCharacters(out, 's', data, length);
+				}
+			};
+			template <>
+			struct captureImplementation<bool, other_spec>
+			{
+				FMTG_INLINE void operator()(buffer& out, bool value) const
+				{
+					out.push_back('b');
+					out.push_back(value ? 1 : 0);
+				}
+			};
+			/** Characters of char types are written the same way. */
+			struct characterCapture
+			{
+				FMTG_INLINE void operator()(buffer& out, char value) const
+				{
+					out.push_back('c');
+					out.push_back(value);
+				}
+			};
+			template <>
+			struct captureImplementation<char, other_spec> : public characterCapture
+			{
+			};
+			template <>
+			struct captureImplementation<signed char, other_spec> : public characterCapture
+			{
+			};
+			template <>
+			struct captureImplementation<unsigned char, other_spec> : public characterCapture
+			{
+			};
+
+			/** Captures elements of containers like @ref rangeImplementation 
+			 * writes them, elements of maps are captured as key and value. */
+			template <typename Container, char open, char close, bool key_value = false>
+			struct rangeCapture
+			{
+				FMTG_INLINE void operator()(buffer& out, const Container& container) const
+				{
+					out.push_back('r');
+					out.push_back(open);
+					out.push_back(close);
+					appendRaw(out, static_cast<std::uint32_t>(container.size()));
+					for (typename Container::const_iterator it = container.begin(); it != container.end(); ++it)
+						captureElement(out, *it, std::integral_constant<bool, key_value>());
+				}
+			private:
+				template <typename T>
+				FMTG_INLINE void captureElement(buffer& out, const T& element, std::false_type) const
+				{
+					captureValue(out, element);
+				}
+				template <typename T>
+				FMTG_INLINE void captureElement(buffer& out, const T& element, std::true_type) const
+				{
+					out.push_back('k');
+					captureValue(out, element.first);
+					captureValue(out, element.second);
+				}
+			};
+
+			template <typename T, typename A>
+			struct captureImplementation<std::vector<T, A>, other_spec> : 
+				public rangeCapture<std::vector<T, A>, '[', ']'>
+			{
+			};
+			template <typename T, typename A>
+			struct captureImplementation<std::deque<T, A>, other_spec> : 
+				public rangeCapture<std::deque<T, A>, '[', ']'>
+			{
+			};
+			template <typename T, typename A>
+			struct captureImplementation<std::list<T, A>, other_spec> : 
+				public rangeCapture<std::list<T, A>, '[', ']'>
+			{
+			};
+			template <typename T, std::size_t N>
+			struct captureImplementation<std::array<T, N>, other_spec> : 
+				public rangeCapture<std::array<T, N>, '[', ']'>
+			{
+			};
+			template <typename T, typename C, typename A>
+			struct captureImplementation<std::set<T, C, A>, other_spec> : 
+				public rangeCapture<std::set<T, C, A>, '{', '}'>
+			{
+			};
+			template <typename T, typename C, typename A>
+			struct captureImplementation<std::multiset<T, C, A>, other_spec> : 
+				public rangeCapture<std::multiset<T, C, A>, '{', '}'>
+			{
+			};
+			template <typename T, typename H, typename E, typename A>
+			struct captureImplementation<std::unordered_set<T, H, E, A>, other_spec> : 
+				public rangeCapture<std::unordered_set<T, H, E, A>, '{', '}'>
+			{
+			};
+			template <typename K, typename V, typename C, typename A>
+			struct captureImplementation<std::map<K, V, C, A>, other_spec> : 
+				public rangeCapture<std::map<K, V, C, A>, '{', '}', true>
+			{
+			};
+			template <typename K, typename V, typename C, typename A>
+			struct captureImplementation<std::multimap<K, V, C, A>, other_spec> : 
+				public rangeCapture<std::multimap<K, V, C, A>, '{', '}', true>
+			{
+			};
+			template <typename K, typename V, typename H, typename E, typename A>
+			struct captureImplementation<std::unordered_map<K, V, H, E, A>, other_spec> : 
+				public rangeCapture<std::unordered_map<K, V, H, E, A>, '{', '}', true>
+			{
+			};
+			template <typename T1, typename T2>
+			struct captureImplementation<std::pair<T1, T2>, other_spec>
+			{
+				FMTG_INLINE void operator()(buffer& out, const std::pair<T1, T2>& value) const
+				{
+					out.push_back('r');
+					out.push_back('(');
+					out.push_back(')');
+					appendRaw(out, static_cast<std::uint32_t>(2));
+					captureValue(out, value.first);
+					captureValue(out, value.second);
+				}
+			};
+		}
+
+		/** Appends the captured value. */
+		template <typename T>
+		FMTG_INLINE void captureValue(buffer& out, const T& value)
+		{
+			typedef typename decayed<T>::type value_type;
+			captureImplementation<value_type>()(out, value);
+		}
+		template <typename T>
+		FMTG_INLINE void captureValue(buffer& out, const wrappers::NamedWrapper<T>& value)
+		{
+			const std::size_t length = std::strlen(value.name_) + 1;
+			appendCharacters(out, 'n', value.name_, length);
+			captureValue(out, value.value_);
+		}
+
+		FMTG_INLINE void captureValues(buffer&)
+		{
+		}
+		template <typename T, typename... Rest>
+		FMTG_INLINE void captureValues(buffer& out, const T& value, const Rest&... rest)
+		{
+			captureValue(out, value);
+			captureValues(out, rest...);
+		}
+
+		/** Returns true if size bytes are left before end, records
+		 * known to be complete are read with NULL end. */
+		FMTG_INLINE bool fits(const char* p, const char* end, std::size_t size)
+		{
+			return end == NULL || static_cast<std::size_t>(end - p) >= size;
+		}
+
+		/** Maximal nesting of containers, pairs and names in a
+		 * captured value, deeper values are malformed, so that
+		 * reading records from files can't exhaust the stack. */
+		static const std::size_t max_captured_depth = 64;
+
+		/** Returns the pointer past the captured value that
+		 * starts at p or NULL if it doesn't end before end or
+		 * is nested deeper than @ref max_captured_depth. */
+		FMTG_INLINE const char* capturedEnd(const char* p, const char* end, std::size_t depth = 0)
+		{
+			if (p == NULL || depth > max_captured_depth || !fits(p, end, 1))
+				return NULL;
+			std::size_t size = 0;
+			const char tag = *p++;
+			switch (tag)
+			{
+				case 'i':
+					size = sizeof(long long);
+					break;
+				case 'u':
+					size = sizeof(unsigned long long);
+					break;
+				case 'f':
+					size = sizeof(float);
+					break;
+				case 'd':
+					size = sizeof(double);
+					break;
+				case 'L':
+					size = sizeof(long double);
+					break;
+				case 'b':
+				case 'c':
+					size = 1;
+					break;
+				case 's':
+				case 't':
+				case 'n':
+					if (!fits(p, end, 4))
+						return NULL;
+					size = 4 + readRaw<std::uint32_t>(p);
+					p -= 4;
+					break;
+				case 'r':
+				{
+					if (!fits(p, end, 6))
+						return NULL;
+					p += 2;
+					const std::uint32_t n = readRaw<std::uint32_t>(p);
+					for (std::uint32_t i=0; i<n && p != NULL; i++)
+						p = capturedEnd(p, end, depth + 1);
+					return p;
+				}
+				case 'k':
+					return capturedEnd(capturedEnd(p, end, depth + 1), end, depth + 1);
+				default:
+					return NULL;
+			}
+			if (!fits(p, end, size))
+				return NULL;
+			p += size;
+			return tag == 'n' ? capturedEnd(p, end, depth + 1) : p;
+		}
+
+		/** Value captured in a record, it is written as the
+		 * value it was captured from would be. */
+		struct captured_value
+		{
+			explicit captured_value(const char* data) :
+				data_(data)
+			{
+			}
+			/** The tag of the value. */
+			const char* data_;
+		};
+
+		/** Writes the captured value that starts at p and
+		 * returns the pointer past it or NULL if it is nested
+		 * deeper than @ref max_captured_depth or has an unknown
+		 * tag. */
+		FMTG_INLINE const char* writeCaptured(buffer& formatted, const char* p, std::size_t depth = 0)
+		{
+			if (depth > max_captured_depth)
+				return NULL;
+			switch (*p++)
+			{
+				case 'i':
+					writeArgument(formatted, readRaw<long long>(p));
+					return p;
+				case 'u':
+					writeArgument(formatted, readRaw<unsigned long long>(p));
+					return p;
+				case 'f':
+					writeArgument(formatted, readRaw<float>(p));
+					return p;
+				case 'd':
+					writeArgument(formatted, readRaw<double>(p));
+					return p;
+				case 'L':
+					writeArgument(formatted, readRaw<long double>(p));
+					return p;
+				case 'b':
+					writeArgument(formatted, *p != 0);
+					return p + 1;
+				case 'c':
+					writeArgument(formatted, *p);
+					return p + 1;
+				case 's':
+				case 't':
+				{
+					const std::uint32_t length = readRaw<std::uint32_t>(p);
+					formatted.append(p, p + length);
+					return p + length;
+				}
+				case 'n':
+				{
+					// names only matter for the arguments, the
+					// values named inside others are written as they are
+					const std::uint32_t length = readRaw<std::uint32_t>(p);
+					return writeCaptured(formatted, p + length, depth + 1);
+				}
+				case 'r':
+				{
+					const char open = *p++;
+					const char close = *p++;
+					const std::uint32_t n = readRaw<std::uint32_t>(p);
+					formatted.push_back(open);
+					for (std::uint32_t i=0; i<n && p != NULL; i++)
+					{
+						if (i != 0)
+							formatted.append(element_separator, element_separator + 2);
+						p = writeCaptured(formatted, p, depth + 1);
+					}
+					formatted.push_back(close);
+					return p;
+				}
+				case 'k':
+					p = writeCaptured(formatted, p, depth + 1);
+					if (p == NULL)
+						return NULL;
+					formatted.push_back(':');
+					formatted.push_back(' ');
+					return writeCaptured(formatted, p, depth + 1);
+				default:
+					return NULL;
+			}
+		}
+
+		namespace
+		{
+			template <>
+			struct dispatchImplementation<captured_value>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const captured_value& value) const
+				{
+					writeCaptured(formatted, value.data_);
+				}
+				FMTG_INLINE std::size_t size_hint(const captured_value&) const
+				{
+					return default_size_hint;
+				}
+			};
+		}
+
+		/** Applies the spec to the captured value as to the
+		 * value it was captured from.
+		 *
+		 * @return false if the presentation type doesn't apply
+		 */
+		FMTG_INLINE bool writeWithSpec(buffer& formatted, const captured_value& value, const format_spec& spec,
+		                               rendered& output)
+		{
+			const char* p = value.data_ + 1;
+			switch (value.data_[0])
+			{
+				case 'i':
+					return writeWithSpec(formatted, readRaw<long long>(p), spec);
+				case 'u':
+					return writeWithSpec(formatted, readRaw<unsigned long long>(p), spec);
+				case 'f':
+					return writeWithSpec(formatted, readRaw<float>(p), spec);
+				case 'd':
+					return writeWithSpec(formatted, readRaw<double>(p), spec);
+				case 'L':
+					return writeWithSpec(formatted, readRaw<long double>(p), spec);
+				case 's':
+				{
+					if (!presentationApplies(spec.type_, string_spec))
+						return false;
+					const std::uint32_t length = readRaw<std::uint32_t>(p);
+					writeStringWithSpec(formatted, p, length, spec);
+					return true;
+				}
+				default:
+					specImplementation<captured_value, other_spec>()(formatted, value, spec, output);
+					return true;
+			}
+		}
+
+		/** Renders the entry record with the formatting string. */
+		template <typename ErrorPolicy>
+		FMTG_INLINE void renderEntry(buffer& out, const char* record, const char* formatter, std::size_t length,
+		                             ErrorPolicy& report)
+		{
+			const char* p = record + 1 + sizeof(std::uint32_t);
+			const std::size_t n_arguments = static_cast<unsigned char>(*p++);
+			std::vector<captured_value> values;
+			std::vector<ValueWrapper> arguments;
+			std::vector<const ValueWrapper*> pointers(n_arguments + 1);
+			std::vector<rendered> outputs(n_arguments + 1);
+			values.reserve(n_arguments);
+			arguments.reserve(n_arguments);
+			// a value nested too deep ends the record, the arguments
+			// after it are missing
+			for (std::size_t i=0; i<n_arguments && p != NULL; i++)
+			{
+				const char* name = NULL;
+				if (*p == 'n')
+				{
+					p++;
+					const std::uint32_t name_length = readRaw<std::uint32_t>(p);
+					name = p;
+					p += name_length;
+				}
+				values.push_back(captured_value(p));
+				arguments.push_back(ValueWrapper(values.back(), name));
+				pointers[i] = &arguments.back();
+				p = capturedEnd(p, NULL);
+			}
+			formatArguments(out, formatter, length, wrapped_arguments(pointers.data(), arguments.size()), 
+			                outputs.data(), report);
+		}
+	}
+
+	/** A formatting string whose calls capture the arguments into
+	 * binary records instead of converting them to text, the text
+	 * is produced by @ref render later and is the same as
+	 * @ref format would produce.
+	 *
+	 * The string is registered once and records refer to it by id,
+	 * @ref write_templates writes the strings for offline decoding.
+	 *
+	 * E.g.
+	 * 	static const formatting::deferred_format line("{} took {:.3f} ms");
+	 * 	line.capture(records, "request", 1.25);
+	 * 	...
+	 * 	formatting::render(records.data()); // => 'request took 1.250 ms'
+	 */
+	class deferred_format
+	{
+	public:
+		explicit deferred_format(const std::string& fmt) :
+			id_(internal::template_registry::instance().add(fmt))
+		{
+		}
+		/** Appends the record of the arguments to out. Numbers,
+		 * characters, strings and containers of them are copied
+		 * as they are, other types are converted to text. */
+		template <typename... Args>
+		FMTG_INLINE void capture(buffer& out, const Args&... args) const
+		{
+			static_assert(sizeof...(Args) < 256, "Records have at most 255 arguments");
+			out.push_back(internal::entry_record);
+			internal::appendRaw(out, id_);
+			out.push_back(static_cast<char>(sizeof...(Args)));
+			internal::captureValues(out, args...);
+		}
+		FMTG_INLINE std::uint32_t id() const
+		{
+			return id_;
+		}
+	private:
+		std::uint32_t id_;
+	};
+
+	/** Returns the pointer past the record or NULL if the
+	 * record is not complete before end. */
+	FMTG_INLINE const char* record_end(const char* record, const char* end)
+	{
+		if (end - record < 1 + static_cast<std::ptrdiff_t>(sizeof(std::uint32_t)) + 1)
+			return NULL;
+		const char* p = record + 1;
+		const std::uint32_t id_or_length = internal::readRaw<std::uint32_t>(p);
+		(void)id_or_length;
+		if (*record == internal::template_record)
+		{
+			if (end - p < static_cast<std::ptrdiff_t>(sizeof(std::uint32_t)))
+				return NULL;
+			const std::uint32_t length = internal::readRaw<std::uint32_t>(p);
+			return static_cast<std::size_t>(end - p) < length ? NULL : p + length;
+		}
+		if (*record != internal::entry_record)
+			return NULL;
+		const std::size_t n_arguments = static_cast<unsigned char>(*p++);
+		for (std::size_t i=0; i<n_arguments && p != NULL; i++)
+			p = internal::capturedEnd(p, end);
+		return p;
+	}
+
+	/** Returns the id of the formatting string of the record. */
+	FMTG_INLINE std::uint32_t record_id(const char* record)
+	{
+		const char* p = record + 1;
+		return internal::readRaw<std::uint32_t>(p);
+	}
+
+	/** Returns true if the record is written by @ref write_templates. */
+	FMTG_INLINE bool is_template_record(const char* record)
+	{
+		return *record == internal::template_record;
+	}
+
+	/** Returns the formatting string of the template record. */
+	FMTG_INLINE std::string template_string(const char* record)
+	{
+		const char* p = record + 1 + sizeof(std::uint32_t);
+		const std::uint32_t length = internal::readRaw<std::uint32_t>(p);
+		return std::string(p, length);
+	}
+
+	/** Appends template records of all registered formatting
+	 * strings, records that are decoded by another process
+	 * are rendered with them. */
+	FMTG_INLINE void write_templates(buffer& out)
+	{
+		internal::template_registry& registry = internal::template_registry::instance();
+		const std::size_t n_templates = registry.size();
+		for (std::uint32_t id=0; id<n_templates; id++)
+		{
+			const std::string& formatter = *registry.find(id);
+			out.push_back(internal::template_record);
+			internal::appendRaw(out, id);
+			internal::appendRaw(out, static_cast<std::uint32_t>(formatter.length()));
+			out.append(formatter);
+		}
+	}
+
+	/** Appends the text of the entry record formatted with the
+	 * provided formatting string.
+	 *
+	 * @param out the buffer to append to
+	 * @param record the complete entry record, see @ref record_end
+	 * @param fmt the formatting string the record was captured with
+	 * @throw formatting_error in case the arguments don't match the
+	 *        placeholders and ErrorPolicy is @ref throw_errors
+	 */
+	template <typename ErrorPolicy = throw_errors>
+	FMTG_INLINE void render(buffer& out, const char* record, const std::string& fmt)
+	{
+		ErrorPolicy report;
+		internal::renderEntry(out, record, fmt.data(), fmt.length(), report);
+	}
+
+	/** Appends the text of the entry record captured by a
+	 * @ref deferred_format of this process. */
+	template <typename ErrorPolicy = throw_errors>
+	FMTG_INLINE void render(buffer& out, const char* record)
+	{
+		ErrorPolicy report;
+		const std::string* formatter = internal::template_registry::instance().find(record_id(record));
+		if (formatter == NULL)
+			report(out, unknown_template, NULL, 0);
+		else
+			internal::renderEntry(out, record, formatter->data(), formatter->length(), report);
+	}
+
+	/** Returns the text of the entry record captured by a
+	 * @ref deferred_format of this process. */
+	template <typename ErrorPolicy = throw_errors>
+	FMTG_INLINE std::string render(const char* record)
+	{
+		std::string rendered;
+		internal::string_buffer buffer(rendered);
+		render<ErrorPolicy>(buffer, record);
+		buffer.finish();
+		return rendered;
+	}
+}
+
+#endif
+#endif
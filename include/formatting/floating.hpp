@@ -0,0 +1,868 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FORMATTING_FLOATING_H_
+#define FORMATTING_FLOATING_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace formatting
+{
+	namespace internal
+	{
+		/** Decomposition of an IEEE-754 number to
+		 * significand * 2^exponent. */
+		struct decomposed_float
+		{
+			enum category { zero, finite, infinite, not_a_number };
+
+			unsigned long long significand;
+			int exponent;
+			/** True if the lower neighbour is closer than the upper one. */
+			bool lower_closer;
+			bool negative;
+			category kind;
+		};
+
+		template <typename T> struct ieee_traits { };
+		template <> struct ieee_traits<double>
+		{
+			typedef unsigned long long bits_type;
+			enum { significand_size = 52, exponent_size = 11, exponent_bias = 1023 + 52 };
+		};
+		template <> struct ieee_traits<float>
+		{
+			typedef unsigned int bits_type;
+			enum { significand_size = 23, exponent_size = 8, exponent_bias = 127 + 23 };
+		};
+
+		template <typename T>
+		FMTG_INLINE decomposed_float decompose(T value)
+		{
+			typedef ieee_traits<T> traits;
+			typename traits::bits_type bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			const unsigned long long hidden_bit = 1ULL << traits::significand_size;
+			const unsigned long long fraction = bits & (hidden_bit - 1);
+			const int biased_exponent = static_cast<int>(bits >> traits::significand_size) & 
+			                            ((1 << traits::exponent_size) - 1);
+			decomposed_float result;
+			result.negative = (bits >> (sizeof(bits)*8 - 1)) != 0;
+			result.lower_closer = false;
+			if (biased_exponent == (1 << traits::exponent_size) - 1)
+			{
+				result.kind = fraction ? decomposed_float::not_a_number : decomposed_float::infinite;
+				result.significand = 0;
+				result.exponent = 0;
+			}
+			else if (biased_exponent == 0)
+			{
+				result.kind = fraction ? decomposed_float::finite : decomposed_float::zero;
+				result.significand = fraction;
+				result.exponent = 1 - traits::exponent_bias;
+			}
+			else
+			{
+				result.kind = decomposed_float::finite;
+				result.significand = fraction | hidden_bit;
+				result.exponent = biased_exponent - traits::exponent_bias;
+				result.lower_closer = fraction == 0 && biased_exponent > 1;
+			}
+			return result;
+		}
+
+		/** Floating point number f * 2^e with 64-bit significand. */
+		struct diy_fp
+		{
+			diy_fp(unsigned long long f, int e) : f_(f), e_(e) { }
+			unsigned long long f_;
+			int e_;
+		};
+
+		FMTG_INLINE diy_fp multiply(const diy_fp& a, const diy_fp& b)
+		{
+			const unsigned long long mask = 0xFFFFFFFFULL;
+			const unsigned long long a_high = a.f_ >> 32, a_low = a.f_ & mask;
+			const unsigned long long b_high = b.f_ >> 32, b_low = b.f_ & mask;
+			const unsigned long long high_high = a_high * b_high;
+			const unsigned long long low_high = a_low * b_high;
+			const unsigned long long high_low = a_high * b_low;
+			const unsigned long long low_low = a_low * b_low;
+			// rounds the lower half
+			const unsigned long long middle = (low_low >> 32) + (high_low & mask) + 
+			                                  (low_high & mask) + (1ULL << 31);
+			return diy_fp(high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32),
+			              a.e_ + b.e_ + 64);
+		}
+
+		FMTG_INLINE diy_fp normalize(diy_fp value)
+		{
+			while (!(value.f_ & 0xFFC0000000000000ULL))
+			{
+				value.f_ <<= 10;
+				value.e_ -= 10;
+			}
+			while (!(value.f_ & 0x8000000000000000ULL))
+			{
+				value.f_ <<= 1;
+				value.e_ -= 1;
+			}
+			return value;
+		}
+
+		/** Normalized 10^decimal_exponent = significand * 2^binary_exponent. */
+		struct cached_power
+		{
+			unsigned long long significand;
+			short binary_exponent;
+			short decimal_exponent;
+		};
+
+		/** Powers of ten from 10^-348 to 10^340 with step 8. */
+		static const cached_power cached_powers[] =
+		{
+			{0xFA8FD5A0081C0288ULL, -1220, -348},
+			{0xBAAEE17FA23EBF76ULL, -1193, -340},
+			{0x8B16FB203055AC76ULL, -1166, -332},
+			{0xCF42894A5DCE35EAULL, -1140, -324},
+			{0x9A6BB0AA55653B2DULL, -1113, -316},
+			{0xE61ACF033D1A45DFULL, -1087, -308},
+			{0xAB70FE17C79AC6CAULL, -1060, -300},
+			{0xFF77B1FCBEBCDC4FULL, -1034, -292},
+			{0xBE5691EF416BD60CULL, -1007, -284},
+			{0x8DD01FAD907FFC3CULL, -980, -276},
+			{0xD3515C2831559A83ULL, -954, -268},
+			{0x9D71AC8FADA6C9B5ULL, -927, -260},
+			{0xEA9C227723EE8BCBULL, -901, -252},
+			{0xAECC49914078536DULL, -874, -244},
+			{0x823C12795DB6CE57ULL, -847, -236},
+			{0xC21094364DFB5637ULL, -821, -228},
+			{0x9096EA6F3848984FULL, -794, -220},
+			{0xD77485CB25823AC7ULL, -768, -212},
+			{0xA086CFCD97BF97F4ULL, -741, -204},
+			{0xEF340A98172AACE5ULL, -715, -196},
+			{0xB23867FB2A35B28EULL, -688, -188},
+			{0x84C8D4DFD2C63F3BULL, -661, -180},
+			{0xC5DD44271AD3CDBAULL, -635, -172},
+			{0x936B9FCEBB25C996ULL, -608, -164},
+			{0xDBAC6C247D62A584ULL, -582, -156},
+			{0xA3AB66580D5FDAF6ULL, -555, -148},
+			{0xF3E2F893DEC3F126ULL, -529, -140},
+			{0xB5B5ADA8AAFF80B8ULL, -502, -132},
+			{0x87625F056C7C4A8BULL, -475, -124},
+			{0xC9BCFF6034C13053ULL, -449, -116},
+			{0x964E858C91BA2655ULL, -422, -108},
+			{0xDFF9772470297EBDULL, -396, -100},
+			{0xA6DFBD9FB8E5B88FULL, -369, -92},
+			{0xF8A95FCF88747D94ULL, -343, -84},
+			{0xB94470938FA89BCFULL, -316, -76},
+			{0x8A08F0F8BF0F156BULL, -289, -68},
+			{0xCDB02555653131B6ULL, -263, -60},
+			{0x993FE2C6D07B7FACULL, -236, -52},
+			{0xE45C10C42A2B3B06ULL, -210, -44},
+			{0xAA242499697392D3ULL, -183, -36},
+			{0xFD87B5F28300CA0EULL, -157, -28},
+			{0xBCE5086492111AEBULL, -130, -20},
+			{0x8CBCCC096F5088CCULL, -103, -12},
+			{0xD1B71758E219652CULL, -77, -4},
+			{0x9C40000000000000ULL, -50, 4},
+			{0xE8D4A51000000000ULL, -24, 12},
+			{0xAD78EBC5AC620000ULL, 3, 20},
+			{0x813F3978F8940984ULL, 30, 28},
+			{0xC097CE7BC90715B3ULL, 56, 36},
+			{0x8F7E32CE7BEA5C70ULL, 83, 44},
+			{0xD5D238A4ABE98068ULL, 109, 52},
+			{0x9F4F2726179A2245ULL, 136, 60},
+			{0xED63A231D4C4FB27ULL, 162, 68},
+			{0xB0DE65388CC8ADA8ULL, 189, 76},
+			{0x83C7088E1AAB65DBULL, 216, 84},
+			{0xC45D1DF942711D9AULL, 242, 92},
+			{0x924D692CA61BE758ULL, 269, 100},
+			{0xDA01EE641A708DEAULL, 295, 108},
+			{0xA26DA3999AEF774AULL, 322, 116},
+			{0xF209787BB47D6B85ULL, 348, 124},
+			{0xB454E4A179DD1877ULL, 375, 132},
+			{0x865B86925B9BC5C2ULL, 402, 140},
+			{0xC83553C5C8965D3DULL, 428, 148},
+			{0x952AB45CFA97A0B3ULL, 455, 156},
+			{0xDE469FBD99A05FE3ULL, 481, 164},
+			{0xA59BC234DB398C25ULL, 508, 172},
+			{0xF6C69A72A3989F5CULL, 534, 180},
+			{0xB7DCBF5354E9BECEULL, 561, 188},
+			{0x88FCF317F22241E2ULL, 588, 196},
+			{0xCC20CE9BD35C78A5ULL, 614, 204},
+			{0x98165AF37B2153DFULL, 641, 212},
+			{0xE2A0B5DC971F303AULL, 667, 220},
+			{0xA8D9D1535CE3B396ULL, 694, 228},
+			{0xFB9B7CD9A4A7443CULL, 720, 236},
+			{0xBB764C4CA7A44410ULL, 747, 244},
+			{0x8BAB8EEFB6409C1AULL, 774, 252},
+			{0xD01FEF10A657842CULL, 800, 260},
+			{0x9B10A4E5E9913129ULL, 827, 268},
+			{0xE7109BFBA19C0C9DULL, 853, 276},
+			{0xAC2820D9623BF429ULL, 880, 284},
+			{0x80444B5E7AA7CF85ULL, 907, 292},
+			{0xBF21E44003ACDD2DULL, 933, 300},
+			{0x8E679C2F5E44FF8FULL, 960, 308},
+			{0xD433179D9C8CB841ULL, 986, 316},
+			{0x9E19DB92B4E31BA9ULL, 1013, 324},
+			{0xEB96BF6EBADF77D9ULL, 1039, 332},
+			{0xAF87023B9BF0EE6BULL, 1066, 340}
+		};
+
+		/** Returns the cached power of ten c such that the product
+		 * of c and a number with binary exponent e has the binary
+		 * exponent in [-60, -32] given min_exponent = -60 - (e + 64). */
+		FMTG_INLINE const cached_power& cachedPower(int min_exponent)
+		{
+			// 1/log2(10)
+			const int k = static_cast<int>(std::ceil((min_exponent + 63) * 0.30102999566398114));
+			return cached_powers[(348 + k - 1) / 8 + 1];
+		}
+
+		/** Moves the last digit closer to the value while it stays in the
+		 * unsafe interval. Returns false if the result can't be proven to
+		 * be the closest shortest representation. */
+		FMTG_INLINE bool roundWeed(char* digits, int length, unsigned long long distance_too_high_w,
+		                           unsigned long long unsafe_interval, unsigned long long rest,
+		                           unsigned long long ten_kappa, unsigned long long unit)
+		{
+			const unsigned long long small_distance = distance_too_high_w - unit;
+			const unsigned long long big_distance = distance_too_high_w + unit;
+			while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+			       (rest + ten_kappa < small_distance ||
+			        small_distance - rest >= rest + ten_kappa - small_distance))
+			{
+				digits[length - 1]--;
+				rest += ten_kappa;
+			}
+			if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+			    (rest + ten_kappa < big_distance ||
+			     big_distance - rest > rest + ten_kappa - big_distance))
+				return false;
+			return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+		}
+
+		/** Generates the shortest digits of w that are in (low, high). */
+		FMTG_INLINE bool generateDigits(const diy_fp& low, const diy_fp& w, const diy_fp& high,
+		                                char* digits, int& length, int& kappa)
+		{
+			unsigned long long unit = 1;
+			const diy_fp too_low(low.f_ - unit, low.e_);
+			const diy_fp too_high(high.f_ + unit, high.e_);
+			diy_fp unsafe_interval(too_high.f_ - too_low.f_, too_high.e_);
+			const diy_fp one(1ULL << -w.e_, w.e_);
+			unsigned int integrals = static_cast<unsigned int>(too_high.f_ >> -one.e_);
+			unsigned long long fractionals = too_high.f_ & (one.f_ - 1);
+
+			static const unsigned int powers_of_10[] =
+			{
+				1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+			};
+			kappa = integrals ? countDigits(integrals) : 0;
+			unsigned int divisor = kappa ? powers_of_10[kappa - 1] : 0;
+			length = 0;
+			while (kappa > 0)
+			{
+				digits[length++] = static_cast<char>('0' + integrals / divisor);
+				integrals %= divisor;
+				kappa--;
+				const unsigned long long rest = (static_cast<unsigned long long>(integrals) << -one.e_) + fractionals;
+				if (rest < unsafe_interval.f_)
+					return roundWeed(digits, length, too_high.f_ - w.f_, unsafe_interval.f_, rest,
+					                 static_cast<unsigned long long>(divisor) << -one.e_, unit);
+				divisor /= 10;
+			}
+			for (;;)
+			{
+				fractionals *= 10;
+				unit *= 10;
+				unsafe_interval.f_ *= 10;
+				digits[length++] = static_cast<char>('0' + (fractionals >> -one.e_));
+				fractionals &= one.f_ - 1;
+				kappa--;
+				if (fractionals < unsafe_interval.f_)
+					return roundWeed(digits, length, (too_high.f_ - w.f_) * unit, unsafe_interval.f_,
+					                 fractionals, one.f_, unit);
+			}
+		}
+
+		/** Grisu3 algorithm by Florian Loitsch. Writes the shortest
+		 * digits such that value = digits * 10^exponent or returns
+		 * false in rare cases it can't guarantee the result. */
+		FMTG_INLINE bool grisu3(const decomposed_float& value, char* digits, int& length, int& exponent)
+		{
+			const diy_fp w = normalize(diy_fp(value.significand, value.exponent));
+			const diy_fp plus = normalize(diy_fp((value.significand << 1) + 1, value.exponent - 1));
+			diy_fp minus = value.lower_closer ?
+				diy_fp((value.significand << 2) - 1, value.exponent - 2) :
+				diy_fp((value.significand << 1) - 1, value.exponent - 1);
+			minus.f_ <<= minus.e_ - plus.e_;
+			minus.e_ = plus.e_;
+
+			const cached_power& power = cachedPower(-60 - (w.e_ + 64));
+			const diy_fp ten_mk(power.significand, power.binary_exponent);
+			int kappa;
+			const bool result = generateDigits(multiply(minus, ten_mk), multiply(w, ten_mk),
+			                                   multiply(plus, ten_mk), digits, length, kappa);
+			exponent = kappa - power.decimal_exponent;
+			return result;
+		}
+
+		/** Fixed size unsigned integer that is large enough
+		 * to represent scaled doubles exactly. */
+		class bigint
+		{
+		public:
+			explicit bigint(unsigned long long value = 0) :
+				size_(0)
+			{
+				while (value)
+				{
+					limbs_[size_++] = static_cast<unsigned int>(value);
+					value >>= 32;
+				}
+			}
+			FMTG_INLINE void multiply(unsigned int multiplier)
+			{
+				unsigned long long carry = 0;
+				for (int i=0; i<size_; i++)
+				{
+					carry += static_cast<unsigned long long>(limbs_[i]) * multiplier;
+					limbs_[i] = static_cast<unsigned int>(carry);
+					carry >>= 32;
+				}
+				if (carry)
+					limbs_[size_++] = static_cast<unsigned int>(carry);
+			}
+			FMTG_INLINE void multiplyPow10(int n)
+			{
+				for (; n >= 9; n -= 9)
+					multiply(1000000000);
+				static const unsigned int powers_of_10[] =
+				{
+					1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+				};
+				if (n)
+					multiply(powers_of_10[n]);
+			}
+			FMTG_INLINE void shiftLeft(int n)
+			{
+				if (!size_)
+					return;
+				const int limbs = n / 32, bits = n % 32;
+				if (bits)
+				{
+					limbs_[size_] = 0;
+					for (int i=size_; i>0; i--)
+						limbs_[i] = (limbs_[i] << bits) | (limbs_[i-1] >> (32 - bits));
+					limbs_[0] <<= bits;
+					if (limbs_[size_])
+						size_++;
+				}
+				if (limbs)
+				{
+					for (int i=size_-1; i>=0; i--)
+						limbs_[i + limbs] = limbs_[i];
+					for (int i=0; i<limbs; i++)
+						limbs_[i] = 0;
+					size_ += limbs;
+				}
+			}
+			FMTG_INLINE void add(const bigint& other)
+			{
+				unsigned long long carry = 0;
+				const int size = std::max(size_, other.size_);
+				for (int i=0; i<size; i++)
+				{
+					carry += static_cast<unsigned long long>(i < size_ ? limbs_[i] : 0) + 
+					         (i < other.size_ ? other.limbs_[i] : 0);
+					limbs_[i] = static_cast<unsigned int>(carry);
+					carry >>= 32;
+				}
+				size_ = size;
+				if (carry)
+					limbs_[size_++] = static_cast<unsigned int>(carry);
+			}
+			/** Subtracts other that is not greater than this. */
+			FMTG_INLINE void subtract(const bigint& other)
+			{
+				long long borrow = 0;
+				for (int i=0; i<size_; i++)
+				{
+					borrow += static_cast<long long>(limbs_[i]) - (i < other.size_ ? other.limbs_[i] : 0);
+					limbs_[i] = static_cast<unsigned int>(borrow);
+					borrow = borrow < 0 ? -1 : 0;
+				}
+				while (size_ && !limbs_[size_ - 1])
+					size_--;
+			}
+			/** Replaces this with the remainder of division by
+			 * divisor and returns the quotient that is small. */
+			FMTG_INLINE int divideModulo(const bigint& divisor)
+			{
+				int quotient = 0;
+				while (compare(*this, divisor) >= 0)
+				{
+					subtract(divisor);
+					quotient++;
+				}
+				return quotient;
+			}
+			static FMTG_INLINE int compare(const bigint& a, const bigint& b)
+			{
+				if (a.size_ != b.size_)
+					return a.size_ < b.size_ ? -1 : 1;
+				for (int i=a.size_-1; i>=0; i--)
+				{
+					if (a.limbs_[i] != b.limbs_[i])
+						return a.limbs_[i] < b.limbs_[i] ? -1 : 1;
+				}
+				return 0;
+			}
+			/** Compares a + b with c. */
+			static FMTG_INLINE int comparePlus(const bigint& a, const bigint& b, const bigint& c)
+			{
+				bigint sum(a);
+				sum.add(b);
+				return compare(sum, c);
+			}
+		private:
+			// 1280 bits, doubles scaled by powers of ten take less than 1150
+			enum { capacity = 40 };
+			unsigned int limbs_[capacity + 1];
+			int size_;
+		};
+
+		/** Returns k such that 10^(k-1) <= value < 10^k or k-1. */
+		FMTG_INLINE int estimateDecimalExponent(const decomposed_float& value)
+		{
+			int bit_length = 0;
+			for (unsigned long long significand = value.significand; significand; significand >>= 1)
+				bit_length++;
+			return static_cast<int>(std::ceil((value.exponent + bit_length - 1) * 0.30102999566398114 - 1e-10));
+		}
+
+		/** Scales value = r / s so that r / s = value / 10^k. */
+		FMTG_INLINE void scaleByPow10(bigint& r, bigint& s, bigint* m_plus, bigint* m_minus, int k)
+		{
+			if (k >= 0)
+				s.multiplyPow10(k);
+			else
+			{
+				r.multiplyPow10(-k);
+				if (m_plus) m_plus->multiplyPow10(-k);
+				if (m_minus) m_minus->multiplyPow10(-k);
+			}
+		}
+
+		/** Exact algorithm by Steele, White, Burger and Dybvig that is
+		 * used when Grisu3 fails. Writes the shortest digits closest to
+		 * the value such that value = digits * 10^exponent. */
+		FMTG_INLINE void dragon4Shortest(const decomposed_float& value, char* digits, int& length, int& exponent)
+		{
+			const unsigned int factor = value.lower_closer ? 2 : 1;
+			bigint r(value.significand), s(1), m_plus(factor), m_minus(1);
+			r.multiply(2 * factor);
+			s.multiply(2 * factor);
+			if (value.exponent >= 0)
+			{
+				r.shiftLeft(value.exponent);
+				m_plus.shiftLeft(value.exponent);
+				m_minus.shiftLeft(value.exponent);
+			}
+			else
+				s.shiftLeft(-value.exponent);
+
+			const bool even = (value.significand & 1) == 0;
+			int k = estimateDecimalExponent(value);
+			scaleByPow10(r, s, &m_plus, &m_minus, k);
+			while (even ? bigint::comparePlus(r, m_plus, s) >= 0 : bigint::comparePlus(r, m_plus, s) > 0)
+			{
+				s.multiply(10);
+				k++;
+			}
+
+			length = 0;
+			for (;;)
+			{
+				r.multiply(10);
+				m_plus.multiply(10);
+				m_minus.multiply(10);
+				int digit = r.divideModulo(s);
+				const bool low = even ? bigint::compare(r, m_minus) <= 0 : bigint::compare(r, m_minus) < 0;
+				const bool high = even ? bigint::comparePlus(r, m_plus, s) >= 0 : bigint::comparePlus(r, m_plus, s) > 0;
+				if (low && high)
+				{
+					const int half = bigint::comparePlus(r, r, s);
+					if (half > 0 || (half == 0 && (digit & 1)))
+						digit++;
+				}
+				else if (high)
+					digit++;
+				digits[length++] = static_cast<char>('0' + digit);
+				if (low || high)
+					break;
+			}
+			exponent = k - length;
+		}
+
+		/** Writes n digits of the value correctly rounded (ties to even)
+		 * such that value = digits * 10^exponent. */
+		FMTG_INLINE void dragon4Fixed(const decomposed_float& value, int n, char* digits, int& exponent)
+		{
+			bigint r(value.significand), s(1);
+			if (value.exponent >= 0)
+				r.shiftLeft(value.exponent);
+			else
+				s.shiftLeft(-value.exponent);
+
+			int k = estimateDecimalExponent(value);
+			scaleByPow10(r, s, NULL, NULL, k);
+			while (bigint::compare(r, s) >= 0)
+			{
+				s.multiply(10);
+				k++;
+			}
+
+			for (int i=0; i<n; i++)
+			{
+				r.multiply(10);
+				digits[i] = static_cast<char>('0' + r.divideModulo(s));
+			}
+			const int half = bigint::comparePlus(r, r, s);
+			if (half > 0 || (half == 0 && ((digits[n-1] - '0') & 1)))
+			{
+				int i = n - 1;
+				while (i >= 0 && digits[i] == '9')
+					digits[i--] = '0';
+				if (i < 0)
+				{
+					digits[0] = '1';
+					k++;
+				}
+				else
+					digits[i]++;
+			}
+			exponent = k - n;
+		}
+
+		/** Maximal number of shortest digits of a double. */
+		static const int max_shortest_digits = 17;
+
+		FMTG_INLINE void shortestDigits(const decomposed_float& value, char* digits, int& length, int& exponent)
+		{
+			if (!grisu3(value, digits, length, exponent))
+				dragon4Shortest(value, digits, length, exponent);
+		}
+
+		/** Writes the exponent of the scientific notation
+		 * with the sign and at least two digits. */
+		FMTG_INLINE void writeExponent(buffer& formatted, int exponent)
+		{
+			char characters[8];
+			char* end = characters + sizeof(characters);
+			char* begin = formatDecimal(end, static_cast<unsigned int>(exponent < 0 ? -exponent : exponent));
+			if (end - begin < 2)
+				*--begin = '0';
+			*--begin = exponent < 0 ? '-' : '+';
+			*--begin = 'e';
+			formatted.append(begin, end);
+		}
+
+		/** Writes digits * 10^exponent, the fixed notation is used if
+		 * the exponent of the first digit is in [-4, fixed_limit)
+		 * and the scientific one otherwise. */
+		FMTG_INLINE void writeDecimal(buffer& formatted, bool negative, const char* digits, int length,
+		                              int exponent, int fixed_limit)
+		{
+			while (length > 1 && digits[length - 1] == '0')
+			{
+				length--;
+				exponent++;
+			}
+			if (negative)
+				formatted.push_back('-');
+
+			const int first_exponent = length + exponent - 1;
+			if (first_exponent < -4 || first_exponent >= fixed_limit)
+			{
+				formatted.push_back(digits[0]);
+				if (length > 1)
+				{
+					formatted.push_back('.');
+					formatted.append(digits + 1, digits + length);
+				}
+				writeExponent(formatted, first_exponent);
+			}
+			else if (exponent >= 0)
+			{
+				formatted.append(digits, digits + length);
+				for (int i=0; i<exponent; i++)
+					formatted.push_back('0');
+			}
+			else if (first_exponent >= 0)
+			{
+				formatted.append(digits, digits + first_exponent + 1);
+				formatted.push_back('.');
+				formatted.append(digits + first_exponent + 1, digits + length);
+			}
+			else
+			{
+				formatted.push_back('0');
+				formatted.push_back('.');
+				for (int i=0; i<-first_exponent-1; i++)
+					formatted.push_back('0');
+				formatted.append(digits, digits + length);
+			}
+		}
+
+		/** Writes zeros, infinities and NaNs, returns false for other numbers. */
+		FMTG_INLINE bool writeSpecial(buffer& formatted, const decomposed_float& value)
+		{
+			static const char nan_[] = "nan";
+			static const char inf_[] = "-inf";
+			switch (value.kind)
+			{
+				case decomposed_float::not_a_number:
+					formatted.append(nan_, nan_ + 3);
+					return true;
+				case decomposed_float::infinite:
+					formatted.append(inf_ + (value.negative ? 0 : 1), inf_ + 4);
+					return true;
+				case decomposed_float::zero:
+					if (value.negative)
+						formatted.push_back('-');
+					formatted.push_back('0');
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		/** Writes the shortest representation that converts back
+		 * to the same value. */
+		template <typename T>
+		FMTG_INLINE void writeShortest(buffer& formatted, T value)
+		{
+			const decomposed_float decomposed = decompose(value);
+			if (writeSpecial(formatted, decomposed))
+				return;
+			char digits[max_shortest_digits + 1];
+			int length, exponent;
+			shortestDigits(decomposed, digits, length, exponent);
+			writeDecimal(formatted, decomposed.negative, digits, length, exponent, 16);
+		}
+
+		/** Maximal number of significant digits that are not zeros
+		 * for any double. */
+		static const int max_exact_digits = 768;
+
+		/** Rounds the shortest digits of the value given in digits, length
+		 * and exponent to n significant digits correctly rounded with ties
+		 * to even. Trailing zeros may be omitted so that length can be
+		 * less than n. Digits must have a room for n digits. */
+		FMTG_INLINE void roundedDigits(const decomposed_float& value, int n, char* digits, int& length, int& exponent)
+		{
+			// The shortest digits rounded to n digits are the correctly rounded
+			// value unless n is too large to be padded with zeros, the shortest
+			// digits end exactly in the middle between two candidates or
+			// the value is subnormal and so has less precision.
+			const bool normal = (value.significand >> ieee_traits<double>::significand_size) != 0;
+			if (!normal)
+			{
+				dragon4Fixed(value, n, digits, exponent);
+				length = n;
+				return;
+			}
+			if (length <= n && n <= std::numeric_limits<double>::digits10)
+				return;
+			if (length > n && !(length == n + 1 && digits[n] == '5'))
+			{
+				exponent += length - n;
+				length = n;
+				if (digits[n] >= '5')
+				{
+					int i = n - 1;
+					while (i >= 0 && digits[i] == '9')
+						digits[i--] = '0';
+					if (i < 0)
+					{
+						digits[0] = '1';
+						exponent++;
+					}
+					else
+						digits[i]++;
+				}
+				return;
+			}
+			dragon4Fixed(value, n, digits, exponent);
+			length = n;
+		}
+
+		/** Writes the value with at most precision significant digits
+		 * like the %g conversion of printf (and default iostreams) do. */
+		FMTG_INLINE void writePrecision(buffer& formatted, double value, unsigned int precision)
+		{
+			const decomposed_float decomposed = decompose(value);
+			if (writeSpecial(formatted, decomposed))
+				return;
+
+			const int n = std::max(1, static_cast<int>(std::min(precision, static_cast<unsigned int>(max_exact_digits))));
+			char digits[max_exact_digits];
+			int length, exponent;
+			shortestDigits(decomposed, digits, length, exponent);
+			roundedDigits(decomposed, n, digits, length, exponent);
+			writeDecimal(formatted, decomposed.negative, digits, length, exponent, n);
+		}
+
+		FMTG_INLINE void writeZeros(buffer& formatted, unsigned int n)
+		{
+			static const char zeros[] = "0000000000000000";
+			for (; n > 16; n -= 16)
+				formatted.append(zeros, zeros + 16);
+			formatted.append(zeros, zeros + n);
+		}
+
+		/** Writes the value with precision digits after the point
+		 * in the scientific notation like the %e conversion does. */
+		FMTG_INLINE void writeScientific(buffer& formatted, double value, unsigned int precision)
+		{
+			const decomposed_float decomposed = decompose(value);
+			if (decomposed.kind != decomposed_float::zero && writeSpecial(formatted, decomposed))
+				return;
+
+			char digits[max_exact_digits];
+			int length = 1, exponent = 0;
+			const int n = static_cast<int>(std::min(precision + 1, static_cast<unsigned int>(max_exact_digits)));
+			if (decomposed.kind == decomposed_float::zero)
+				digits[0] = '0';
+			else
+			{
+				shortestDigits(decomposed, digits, length, exponent);
+				roundedDigits(decomposed, n, digits, length, exponent);
+			}
+
+			if (decomposed.negative)
+				formatted.push_back('-');
+			formatted.push_back(digits[0]);
+			if (precision > 0)
+			{
+				formatted.push_back('.');
+				formatted.append(digits + 1, digits + length);
+				writeZeros(formatted, precision + 1 - length);
+			}
+			writeExponent(formatted, length + exponent - 1);
+		}
+
+		/** Writes the value with precision digits after the point
+		 * in the fixed notation like the %f conversion does. */
+		FMTG_INLINE void writeFixed(buffer& formatted, double value, unsigned int precision)
+		{
+			const decomposed_float decomposed = decompose(value);
+			if (decomposed.kind != decomposed_float::zero && writeSpecial(formatted, decomposed))
+				return;
+
+			char digits[max_exact_digits];
+			int length = 0, exponent = 0;
+			if (decomposed.kind != decomposed_float::zero)
+			{
+				shortestDigits(decomposed, digits, length, exponent);
+				// number of digits down to the last written position
+				int n = static_cast<int>(std::min(static_cast<long long>(length + exponent) + precision,
+				                                  static_cast<long long>(max_exact_digits)));
+				if (n > 0)
+				{
+					roundedDigits(decomposed, n, digits, length, exponent);
+					// the shortest digits can overestimate the first digit position by one
+					if (length + exponent + static_cast<int>(precision) < n && n < max_exact_digits)
+					{
+						if (--n > 0)
+						{
+							dragon4Fixed(decomposed, n, digits, exponent);
+							length = n;
+						}
+					}
+				}
+				if (n == 0)
+				{
+					// the value is below the last position and rounds either to zero
+					// or to one at that position, which needs its exact digits
+					dragon4Fixed(decomposed, max_exact_digits, digits, exponent);
+					const char* nonzero = digits + 1;
+					while (nonzero != digits + max_exact_digits && *nonzero == '0')
+						nonzero++;
+					const bool up = exponent + max_exact_digits == -static_cast<int>(precision) &&
+						(digits[0] > '5' || (digits[0] == '5' && nonzero != digits + max_exact_digits));
+					digits[0] = up ? '1' : '0';
+					length = up ? 1 : 0;
+					exponent = -static_cast<int>(precision);
+				}
+				else if (n < 0)
+					length = 0;
+			}
+
+			if (decomposed.negative)
+				formatted.push_back('-');
+			const int first_exponent = length + exponent - 1;
+			if (length == 0 || first_exponent < 0)
+				formatted.push_back('0');
+			else if (length <= first_exponent)
+			{
+				formatted.append(digits, digits + length);
+				writeZeros(formatted, first_exponent + 1 - length);
+			}
+			else
+				formatted.append(digits, digits + first_exponent + 1);
+			if (precision == 0)
+				return;
+
+			formatted.push_back('.');
+			unsigned int written = 0;
+			if (length > 0 && first_exponent < -1)
+			{
+				written = std::min(precision, static_cast<unsigned int>(-first_exponent - 1));
+				writeZeros(formatted, written);
+			}
+			if (length > 0 && first_exponent + 1 < length && written < precision)
+			{
+				const int begin = std::max(first_exponent + 1, 0);
+				const int end = std::min(length, begin + static_cast<int>(precision - written));
+				formatted.append(digits + begin, digits + end);
+				written += end - begin;
+			}
+			writeZeros(formatted, precision - written);
+		}
+	}
+}
+#endif
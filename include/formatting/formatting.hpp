@@ -33,14 +33,43 @@
 #define FMTG_INLINE inline
 #if __cplusplus > 199711L
 	#define FMTG_USE_CXX11
+	#define FMTG_CONSTEXPR constexpr
+#else
+	#define FMTG_CONSTEXPR
 #endif
+#if __cplusplus >= 201703L
+	#define FMTG_USE_CXX17
+#endif
+
+/** Define FMTG_NO_IOSTREAM to format built-in types and wrappers
+ * without streams. Streams are then declared only and needed by
+ * the stream insertion operators of user types. Long doubles are
+ * formatted with the precision of double in this mode. */
 
 #include <string>
 #include <stdexcept>
+#ifdef FMTG_NO_IOSTREAM
+#include <iosfwd>
+#else
 #include <sstream>
+#endif
+#ifdef FMTG_USE_CXX11
+#include <tuple>
+#include <type_traits>
+#endif
+#ifdef FMTG_USE_CXX17
+#include <string_view>
+#include <memory_resource>
+#endif
 
+#include <formatting/buffer.hpp>
+#include <formatting/parser.hpp>
+#include <formatting/numbers.hpp>
+#include <formatting/floating.hpp>
 #include <formatting/wrappers.hpp>
 #include <formatting/implementations.hpp>
+#include <formatting/specs.hpp>
+#include <formatting/static_format.hpp>
 
 
 namespace formatting
@@ -54,6 +83,11 @@ namespace formatting
 
 	/** A class that provides a wrapper with ability
 	 * to stringify the value it is created from.
+	 *
+	 * The wrapper refers to the value and doesn't copy it,
+	 * so it is valid only while the value is alive (that is
+	 * true for arguments of any formatting call). Does no
+	 * heap allocations.
 	 */
 	class ValueWrapper;
 
@@ -69,69 +103,887 @@ namespace formatting
 		}
 	};
 
-	/** Internal namespace that contains implementations. */
-	namespace internal
+	/** Errors of formatting strings and arguments that are
+	 * reported to error policies. */
+	enum error_code
+	{
+		no_error = 0,
+		/** A {} field has no argument left. */
+		missing_argument,
+		/** Arguments are left with no {} field for them. */
+		unused_arguments,
+		/** A {n} field refers to an argument that is not provided. */
+		index_out_of_range,
+		/** A {name} field refers to a name no argument has. */
+		unknown_name,
+		/** A deferred record refers to a formatting string that is not known. */
+		unknown_template,
+		/** A field has a format spec that can't be parsed or that
+		 * doesn't apply to the type of its argument. */
+		invalid_spec,
+		/** {} fields are mixed with {n} ones. */
+		mixed_indexing
+	};
+
+	/** Returns the description of the error. */
+	FMTG_INLINE const char* error_message(error_code code)
 	{
-		/** Implementation that is used by @ref ValueWrapper.
-		 * It is able to convert the underlying value to string. */
-		class ValueWrapperImplementationBase;
+		switch (code)
+		{
+			case no_error:
+				return "No error";
+			case missing_argument:
+			case unused_arguments:
+				return "The number of placeholders doesn't match the number of provided arguments";
+			case index_out_of_range:
+				return "The argument index is out of range";
+			case unknown_name:
+				return "There is no argument named";
+			case unknown_template:
+				return "The formatting string of the record is not known";
+			case invalid_spec:
+				return "The format spec of the field is invalid";
+			case mixed_indexing:
+				return "Automatic and explicit argument indices are mixed";
+		}
+		return "Unknown error";
 	}
 
+	/** Error policy that throws @ref formatting_error, 
+	 * it is used by default. */
+	struct throw_errors
+	{
+		FMTG_INLINE void operator()(buffer&, error_code code, const char* name, std::size_t length) const
+		{
+			std::string reason(error_message(code));
+			if (code == unknown_name)
+				reason += " " + std::string(name, length);
+			throw formatting_error(reason);
+		}
+	};
+
+	/** Error policy that never throws and writes a marker like
+	 * {!missing argument} in place of the wrong field, the marker
+	 * of arguments that are left is written at the end. */
+	struct mark_errors
+	{
+		FMTG_INLINE void operator()(buffer& formatted, error_code code, const char* name, std::size_t length) const
+		{
+			static const char* const markers[] = 
+			{
+				"", "{!missing argument}", "{!unused arguments}", "{!index out of range}", "{!unknown name ",
+				"{!unknown template}", "{!invalid spec}", "{!mixed indexing}"
+			};
+			formatted.append(markers[code], markers[code] + std::strlen(markers[code]));
+			if (code == unknown_name)
+			{
+				formatted.append(name, name + length);
+				formatted.push_back('}');
+			}
+		}
+	};
+
+	/** Error policy that never throws and keeps the first error,
+	 * wrong fields are omitted. Used by @ref try_format. */
+	struct keep_error
+	{
+		keep_error() :
+			code_(no_error)
+		{
+		}
+		FMTG_INLINE void operator()(buffer&, error_code code, const char*, std::size_t)
+		{
+			if (code_ == no_error)
+				code_ = code;
+		}
+		error_code code_;
+	};
+
 	class ValueWrapper
 	{
 	public:
-		template<typename T> ValueWrapper(T value) :
-			implementation_(new formatting::internal::ValueWrapperImplementation<T>(value))
+		template<typename T> ValueWrapper(const T& value) :
+			value_(&value), writer_(&formatting::internal::writeValue<T>),
+			spec_writer_(&formatting::internal::writeValueWithSpec<T>),
+			estimator_(&formatting::internal::estimateValue<T>),
+			name_(formatting::internal::argumentName(value))
+		{
+		}
+		/** Wraps the value with the name given like by @ref formatting::arg. */
+		template<typename T> ValueWrapper(const T& value, const char* name) :
+			value_(&value), writer_(&formatting::internal::writeValue<T>),
+			spec_writer_(&formatting::internal::writeValueWithSpec<T>),
+			estimator_(&formatting::internal::estimateValue<T>),
+			name_(name)
 		{
 		}
 		ValueWrapper() :
-			implementation_(new formatting::internal::ValueWrapperImplementation<const char*>("invalid argument"))
+			value_(NULL), writer_(&formatting::internal::writeInvalidArgument),
+			spec_writer_(&formatting::internal::writeInvalidArgumentWithSpec),
+			estimator_(&formatting::internal::estimateInvalidArgument),
+			name_(NULL)
+		{
+		}
+		/** Appends the representation of the value to formatted. */
+		FMTG_INLINE void write(formatting::internal::buffer& formatted) const
+		{
+			writer_(formatted, value_);
+		}
+		/** Appends the representation of the value formatted
+		 * by the spec of the field, output is the representation
+		 * fields of the value with no spec share.
+		 *
+		 * @return false if the presentation type of the spec
+		 *         doesn't apply to the value
+		 */
+		FMTG_INLINE bool write(formatting::internal::buffer& formatted, 
+		                       const formatting::internal::format_spec& spec,
+		                       formatting::internal::rendered& output) const
 		{
+			return spec_writer_(formatted, value_, spec, output);
 		}
-		ValueWrapper(const ValueWrapper& wrapper) :
-			implementation_(wrapper.implementation_)
+		/** Returns the estimated length of the representation. */
+		FMTG_INLINE std::size_t size_hint() const
 		{
+			return estimator_(value_);
 		}
-		~ValueWrapper()
+		/** Returns the name given by @ref formatting::arg or NULL. */
+		FMTG_INLINE const char* name() const
 		{
-			delete implementation_;
+			return name_;
 		}
 		FMTG_INLINE std::string representation() const
 		{
-			return implementation_->representation();
+			std::string formatted;
+			formatting::internal::string_buffer buffer(formatted);
+			write(buffer);
+			buffer.finish();
+			return formatted;
 		}
 	private:
-		const formatting::internal::ValueWrapperImplementationBase* const implementation_;
+		typedef void (*Writer)(formatting::internal::buffer&, const void*);
+		typedef bool (*SpecWriter)(formatting::internal::buffer&, const void*, 
+		                           const formatting::internal::format_spec&, formatting::internal::rendered&);
+		typedef std::size_t (*Estimator)(const void*);
+
+		const void* value_;
+		Writer writer_;
+		SpecWriter spec_writer_;
+		Estimator estimator_;
+		const char* name_;
 	};
 	
 	namespace internal
 	{
+#ifdef FMTG_USE_CXX11
+		/** Formatting string that refers to the characters of a
+		 * string or a string literal without copying them, so
+		 * passing a literal doesn't allocate a temporary string. */
+		class format_string
+		{
+		public:
+			format_string(const char* data) :
+				data_(data), length_(std::strlen(data))
+			{
+			}
+			format_string(const std::string& value) :
+				data_(value.data()), length_(value.length())
+			{
+			}
+#ifdef FMTG_USE_CXX17
+			format_string(std::string_view value) :
+				data_(value.data()), length_(value.length())
+			{
+			}
+#endif
+			FMTG_INLINE const char* data() const
+			{
+				return data_;
+			}
+			FMTG_INLINE std::size_t length() const
+			{
+				return length_;
+			}
+		private:
+			const char* data_;
+			std::size_t length_;
+		};
+#endif
+
+		/** Returns the sum of estimated lengths of arguments. */
+		FMTG_INLINE std::size_t estimateArguments(const ValueWrapper* const* arguments, std::size_t n_arguments)
+		{
+			std::size_t estimated_length = 0;
+			for (std::size_t i=0; i<n_arguments; i++)
+				estimated_length += arguments[i]->size_hint();
+			return estimated_length;
+		}
+
+		/** Arguments referred by @ref ValueWrapper, so that their
+		 * types are erased. Used by the C++98 overloads and by
+		 * arguments that are known at run time only. */
+		class wrapped_arguments
+		{
+		public:
+			wrapped_arguments(const ValueWrapper* const* arguments, std::size_t n_arguments) :
+				arguments_(arguments), n_arguments_(n_arguments)
+			{
+			}
+			FMTG_INLINE std::size_t size() const
+			{
+				return n_arguments_;
+			}
+			/** Appends the representation of the argument i. */
+			FMTG_INLINE void write(buffer& formatted, std::size_t i) const
+			{
+				arguments_[i]->write(formatted);
+			}
+			FMTG_INLINE bool write(buffer& formatted, std::size_t i, const format_spec& spec, rendered& output) const
+			{
+				return arguments_[i]->write(formatted, spec, output);
+			}
+			/** Returns the name of the argument i or NULL. */
+			FMTG_INLINE const char* name(std::size_t i) const
+			{
+				return arguments_[i]->name();
+			}
+			/** Returns the sum of estimated lengths of arguments. */
+			FMTG_INLINE std::size_t size_hint() const
+			{
+				return estimateArguments(arguments_, n_arguments_);
+			}
+		private:
+			const ValueWrapper* const* arguments_;
+			std::size_t n_arguments_;
+		};
+
+#ifdef FMTG_USE_CXX11
+		/* Operations on a single argument for @ref typed_arguments. */
+		struct argument_writer
+		{
+			template <typename T>
+			FMTG_INLINE void operator()(const T& value) const
+			{
+				writeArgument(formatted_, value);
+			}
+			buffer& formatted_;
+		};
+		struct argument_spec_writer
+		{
+			template <typename T>
+			FMTG_INLINE void operator()(const T& value) const
+			{
+				written_ = writeWithSpec(formatted_, value, spec_, output_);
+			}
+			buffer& formatted_;
+			const format_spec& spec_;
+			rendered& output_;
+			bool& written_;
+		};
+		struct argument_name_reader
+		{
+			template <typename T>
+			FMTG_INLINE void operator()(const T& value) const
+			{
+				name_ = argumentName(value);
+			}
+			const char*& name_;
+		};
+		struct argument_estimator
+		{
+			template <typename T>
+			FMTG_INLINE void operator()(const T& value) const
+			{
+				estimated_length_ += estimateArgument(value);
+			}
+			std::size_t& estimated_length_;
+		};
+
+		/** Arguments referred with their static types. The field
+		 * is dispatched to its argument by recursion on the index
+		 * over the pack, so that every argument is written by the
+		 * implementation of its type with no indirect calls. */
+		template <typename... Args>
+		class typed_arguments
+		{
+		public:
+			explicit typed_arguments(const Args&... args) :
+				values_(args...)
+			{
+			}
+			FMTG_INLINE std::size_t size() const
+			{
+				return sizeof...(Args);
+			}
+			/** Appends the representation of the argument i. */
+			FMTG_INLINE void write(buffer& formatted, std::size_t i) const
+			{
+				visit<0>(i, argument_writer{formatted}, std::integral_constant<bool, sizeof...(Args) == 0>());
+			}
+			/** Returns false if the presentation type of the spec
+			 * doesn't apply to the argument i. */
+			FMTG_INLINE bool write(buffer& formatted, std::size_t i, const format_spec& spec, rendered& output) const
+			{
+				bool written = true;
+				visit<0>(i, argument_spec_writer{formatted, spec, output, written}, 
+				         std::integral_constant<bool, sizeof...(Args) == 0>());
+				return written;
+			}
+			/** Returns the name of the argument i or NULL. */
+			FMTG_INLINE const char* name(std::size_t i) const
+			{
+				const char* name = NULL;
+				visit<0>(i, argument_name_reader{name}, std::integral_constant<bool, sizeof...(Args) == 0>());
+				return name;
+			}
+			/** Returns the sum of estimated lengths of arguments. */
+			FMTG_INLINE std::size_t size_hint() const
+			{
+				std::size_t estimated_length = 0;
+				for (std::size_t i=0; i<sizeof...(Args); i++)
+					visit<0>(i, argument_estimator{estimated_length}, std::integral_constant<bool, sizeof...(Args) == 0>());
+				return estimated_length;
+			}
+		private:
+			template <std::size_t I, typename Visitor>
+			FMTG_INLINE void visit(std::size_t i, const Visitor& visitor, std::false_type) const
+			{
+				if (i == I)
+					visitor(std::get<I>(values_));
+				else
+					visit<I + 1>(i, visitor, std::integral_constant<bool, I + 1 == sizeof...(Args)>());
+			}
+			template <std::size_t I, typename Visitor>
+			FMTG_INLINE void visit(std::size_t, const Visitor&, std::true_type) const
+			{
+			}
+
+			std::tuple<const Args&...> values_;
+		};
+#endif
+
+		/** Appends the representation of the argument or copies
+		 * it if the argument was written before and the copy is 
+		 * still in the buffer, so that arguments referred by many
+		 * fields are converted once. */
+		template <typename Arguments>
+		FMTG_INLINE void writeReused(buffer& formatted, const Arguments& arguments, std::size_t index, rendered& output)
+		{
+			if (output.position_ != static_cast<std::size_t>(-1) && 
+			    formatted.repeat(output.position_, output.length_))
+				return;
+			output.position_ = formatted.written();
+			arguments.write(formatted, index);
+			output.length_ = formatted.written() - output.position_;
+		}
+
+		/** Returns the index of the argument with the provided
+		 * name or the number of arguments if there is no such argument. */
+		template <typename Arguments>
+		FMTG_INLINE std::size_t findNamed(const char* name, std::size_t length, const Arguments& arguments)
+		{
+			for (std::size_t i=0; i<arguments.size(); i++)
+			{
+				if (sameName(name, length, arguments.name(i)))
+					return i;
+			}
+			return arguments.size();
+		}
+
+		/** Returns the error of the field that refers to no argument. */
+		FMTG_INLINE error_code fieldError(field::kind kind)
+		{
+			return kind == field::automatic ? missing_argument : 
+			       kind == field::named ? unknown_name : index_out_of_range;
+		}
+
+		/** Appends the formatting string with its fields replaced
+		 * by representations of arguments, {{ and }} are written
+		 * as single braces. 
+		 *
+		 * Fields that refer to no argument are reported to the
+		 * error policy. If all fields are {}, the arguments that
+		 * are left are reported as well, as they are likely to
+		 * be lost by mistake.
+		 */
+		template <typename ErrorPolicy, typename Arguments>
+		FMTG_INLINE void formatArguments(buffer& formatted, const char* formatter, std::size_t length,
+		                                 const Arguments& arguments, rendered* outputs, ErrorPolicy& report)
+		{
+			const std::size_t n_arguments = arguments.size();
+			const char* end = formatter + length;
+			const char* literal = formatter;
+			const char* brace = formatter;
+			std::size_t next_automatic = 0;
+			bool automatic_only = true;
+			field::kind indexing = field::named;
+			while ((brace = findBrace(brace, end)) != end)
+			{
+				if (brace + 1 != end && brace[1] == *brace)
+				{
+					formatted.append(literal, brace + 1);
+					literal = brace = brace + 2;
+					continue;
+				}
+				field parsed;
+				const char* field_end = *brace == '{' ? parseField(brace, end, parsed) : NULL;
+				if (field_end == NULL)
+				{
+					brace++;
+					continue;
+				}
+				formatted.append(literal, brace);
+				literal = brace = field_end;
+				std::size_t index = parsed.index_;
+				if (parsed.kind_ == field::automatic)
+					index = next_automatic++;
+				else
+				{
+					automatic_only = false;
+					if (parsed.kind_ == field::named)
+						index = findNamed(parsed.name_, parsed.name_length_, arguments);
+				}
+				if (parsed.invalid_spec_)
+				{
+					report(formatted, invalid_spec, NULL, 0);
+					continue;
+				}
+				if (mixesIndexing(parsed.kind_, indexing))
+				{
+					report(formatted, mixed_indexing, NULL, 0);
+					continue;
+				}
+				if (index >= n_arguments)
+				{
+					report(formatted, fieldError(parsed.kind_), parsed.name_, parsed.name_length_);
+					continue;
+				}
+				if (parsed.has_spec_)
+				{
+					if (!arguments.write(formatted, index, parsed.spec_, outputs[index]))
+						report(formatted, invalid_spec, NULL, 0);
+				}
+				else
+					writeReused(formatted, arguments, index, outputs[index]);
+			}
+			formatted.append(literal, end);
+			if (automatic_only && next_automatic < n_arguments)
+				report(formatted, unused_arguments, NULL, 0);
+		}
+
+#ifdef FMTG_USE_CXX11
+		template <typename ErrorPolicy, typename Arguments>
+		FMTG_INLINE bool formatCached(buffer& formatted, const char* formatter, std::size_t length,
+		                              const Arguments& arguments, rendered* outputs, ErrorPolicy& report);
+
+		/** Formats arguments of any types referring to them
+		 * by @ref typed_arguments. The parsed format is taken
+		 * from the format cache if it is enabled. */
+		template <typename ErrorPolicy, typename... Args>
+		FMTG_INLINE void formatVariadic(buffer& formatted, const format_string& formatter, 
+		                                ErrorPolicy& report, const Args&... args)
+		{
+			const typed_arguments<Args...> arguments(args...);
+			rendered outputs[sizeof...(Args) + 1];
+			if (!formatCached(formatted, formatter.data(), formatter.length(), arguments, outputs, report))
+				formatArguments(formatted, formatter.data(), formatter.length(), arguments, outputs, report);
+		}
+#else
 		namespace
 		{
 			std::string formatImplementation(const std::string& formatter,
 											 const ValueWrapper** handlers,
 											 std::size_t n_handlers) 
 			{
-				std::string formatted = formatter;
-				std::size_t placeholder_position = 0; 
-				for (std::size_t i=0; i<n_handlers; i++)
+				std::string formatted;
+				string_buffer buffer(formatted);
+				buffer.reserve(formatter.length() + estimateArguments(handlers, n_handlers));
+				rendered outputs[10];
+				throw_errors report;
+				formatArguments(buffer, formatter.data(), formatter.length(), 
+				                wrapped_arguments(handlers, n_handlers), outputs, report);
+				buffer.finish();
+				return formatted;
+			}
+		}
+#endif
+
+		/** A formatting string split into literal segments
+		 * that surround fields. Literal i precedes field i and
+		 * the last literal follows the last field. Indices of
+		 * fields are resolved once, names are looked up when
+		 * the arguments are provided. Escaped braces of literals
+		 * are collapsed once as well. */
+		class parsed_format
+		{
+		public:
+			explicit parsed_format(const std::string& formatter) :
+				source_(formatter), text_(), literals_(), fields_(),
+				n_arguments_(0), automatic_only_(true)
+			{
+				const char* begin = source_.data();
+				const char* end = begin + source_.length();
+				const char* literal = begin;
+				const char* brace = begin;
+				std::size_t next_automatic = 0;
+				field::kind indexing = field::named;
+				string_buffer text(text_);
+				while ((brace = static_cast<const char*>(std::memchr(brace, '{', end - brace))) != NULL)
+				{
+					if (brace + 1 != end && brace[1] == '{')
+					{
+						brace += 2;
+						continue;
+					}
+					field parsed;
+					const char* field_end = parseField(brace, end, parsed);
+					if (field_end == NULL)
+					{
+						brace++;
+						continue;
+					}
+					const std::size_t text_begin = text.written();
+					appendUnescaped(text, literal, brace);
+					literals_.push_back(segment(text_begin, text.written() - text_begin));
+					if (parsed.kind_ == field::automatic)
+						parsed.index_ = next_automatic++;
+					else
+						automatic_only_ = false;
+					if (parsed.kind_ == field::named)
+						fields_.push_back(segment(parsed.name_ - begin, parsed.name_length_, parsed.kind_));
+					else
+					{
+						fields_.push_back(segment(parsed.index_, 0, parsed.kind_));
+						n_arguments_ = std::max(n_arguments_, parsed.index_ + 1);
+					}
+					fields_.back().spec_ = parsed.spec_;
+					fields_.back().has_spec_ = parsed.has_spec_;
+					fields_.back().invalid_spec_ = parsed.invalid_spec_;
+					fields_.back().mixed_indexing_ = mixesIndexing(parsed.kind_, indexing);
+					literal = brace = field_end;
+				}
+				const std::size_t text_begin = text.written();
+				appendUnescaped(text, literal, end);
+				literals_.push_back(segment(text_begin, text.written() - text_begin));
+				text.finish();
+			}
+			/** Returns the number of fields. */
+			FMTG_INLINE std::size_t n_fields() const
+			{
+				return fields_.size();
+			}
+			/** Returns the number of arguments referred by 
+			 * index or by {}, named arguments are not counted. */
+			FMTG_INLINE std::size_t n_arguments() const
+			{
+				return n_arguments_;
+			}
+			/** Returns true if all fields are {}. */
+			FMTG_INLINE bool automatic_only() const
+			{
+				return automatic_only_;
+			}
+#ifdef FMTG_USE_CXX11
+			template <typename... Args>
+			FMTG_INLINE void apply(buffer& formatted, const Args&... args) const
+			{
+				rendered outputs[sizeof...(Args) + 1];
+				applyArguments(formatted, typed_arguments<Args...>(args...), outputs);
+			}
+#endif
+			/** Writes the arguments into the fields. Errors are reported
+			 * to the policy as @ref formatArguments reports them. */
+			template <typename ErrorPolicy, typename Arguments>
+			FMTG_INLINE void applyArguments(buffer& formatted, const Arguments& arguments, 
+			                                rendered* outputs, ErrorPolicy& report) const
+			{
+				const std::size_t n_arguments = arguments.size();
+				formatted.reserve(text_.length() + arguments.size_hint());
+				for (std::size_t i=0; i<fields_.size(); i++)
 				{
-					placeholder_position = formatted.find(placeholder, placeholder_position);
-					if (placeholder_position != std::string::npos)
+					appendText(formatted, i);
+					const bool named = fields_[i].kind_ == field::named;
+					std::size_t index = fields_[i].begin_;
+					if (named)
+						index = findNamed(source_.data() + fields_[i].begin_, fields_[i].length_, arguments);
+					if (fields_[i].invalid_spec_)
+					{
+						report(formatted, invalid_spec, NULL, 0);
+						continue;
+					}
+					if (fields_[i].mixed_indexing_)
 					{
-						const std::string representation = handlers[i]->representation();
-						formatted.replace(placeholder_position,placeholder.length(),
-										  representation);
-						placeholder_position += representation.length();
+						report(formatted, mixed_indexing, NULL, 0);
+						continue;
+					}
+					if (index >= n_arguments)
+					{
+						report(formatted, fieldError(fields_[i].kind_),
+						       named ? source_.data() + fields_[i].begin_ : NULL, fields_[i].length_);
+						continue;
+					}
+					if (fields_[i].has_spec_)
+					{
+						if (!arguments.write(formatted, index, fields_[i].spec_, outputs[index]))
+							report(formatted, invalid_spec, NULL, 0);
 					}
 					else
-						throw formatting_error("The number of placeholders doesn't match the number of provided arguments");
+						writeReused(formatted, arguments, index, outputs[index]);
 				}
-				return formatted;
+				appendText(formatted, fields_.size());
+				if (automatic_only_ && fields_.size() < n_arguments)
+					report(formatted, unused_arguments, NULL, 0);
 			}
-		}
+			template <typename Arguments>
+			FMTG_INLINE void applyArguments(buffer& formatted, const Arguments& arguments, rendered* outputs) const
+			{
+				throw_errors report;
+				applyArguments(formatted, arguments, outputs, report);
+			}
+			/** Returns the formatting string the format is parsed from. */
+			FMTG_INLINE const std::string& source() const
+			{
+				return source_;
+			}
+			/** Literal segment of the text or field, fields refer to
+			 * arguments by the index in begin_ or by the name in the
+			 * source and keep their parsed spec. */
+			struct segment
+			{
+				segment(std::size_t begin, std::size_t length, field::kind kind = field::automatic) :
+					begin_(begin), length_(length), kind_(kind), spec_(), has_spec_(false), 
+					invalid_spec_(false), mixed_indexing_(false) { }
+				std::size_t begin_;
+				std::size_t length_;
+				field::kind kind_;
+				format_spec spec_;
+				bool has_spec_;
+				bool invalid_spec_;
+				/** The field is {} after {n} ones or the other way around. */
+				bool mixed_indexing_;
+			};
+			/** Returns the field i, see @ref segment. */
+			FMTG_INLINE const segment& field_at(std::size_t i) const
+			{
+				return fields_[i];
+			}
+			/** Provides the literal that precedes field i. */
+			FMTG_INLINE void literal_at(std::size_t i, const char*& data, std::size_t& length) const
+			{
+				data = text_.data() + literals_[i].begin_;
+				length = literals_[i].length_;
+			}
+			/** Returns the length of all literals. */
+			FMTG_INLINE std::size_t text_length() const
+			{
+				return text_.length();
+			}
+		private:
+			FMTG_INLINE void appendText(buffer& formatted, std::size_t i) const
+			{
+				const char* begin = text_.data() + literals_[i].begin_;
+				formatted.append(begin, begin + literals_[i].length_);
+			}
+
+			std::string source_;
+			/** Literals with escaped braces collapsed. */
+			std::string text_;
+			std::vector<segment> literals_;
+			std::vector<segment> fields_;
+			std::size_t n_arguments_;
+			bool automatic_only_;
+		};
+	}
+
+#ifdef FMTG_USE_CXX11
+	/** Constructs a string using the provided formatting string and
+	 * arguments. Essentially, replaces all placeholders ("{}") in the 
+	 * string with the corresponding string representations 
+	 * of provided arguments (in the same order).
+	 *
+	 * This function performs substitution of any number of variables,
+	 * each variable is converted using its static type.
+	 *
+	 * Doesn't change the formatting string.
+	 * Uses no shared state thus supposed to be thread-safe.
+	 *
+	 * Errors are handled by the ErrorPolicy, e.g. 
+	 * format<mark_errors>("{} {}", 1) writes '1 {!missing argument}'.
+	 *
+	 * @param fmt the formatting string that contains {} placeholders,
+	 *        {{ and }} are written as single braces.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @return new string with provided parameters put instead
+	 *         of placeholders to the provided formatting string.
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters and ErrorPolicy is @ref throw_errors
+	 */
+	template <typename ErrorPolicy = throw_errors, typename... Args>
+	FMTG_INLINE std::string format(const internal::format_string& fmt, const Args&... args)
+	{
+		std::string formatted;
+		formatting::internal::string_buffer buffer(formatted);
+		buffer.reserve(fmt.length() + formatting::internal::estimateArguments(args...));
+		ErrorPolicy report;
+		formatting::internal::formatVariadic(buffer, fmt, report, args...);
+		buffer.finish();
+		return formatted;
+	}
+
+	/** Constructs a string like by @ref format and returns the
+	 * error code instead of throwing. Fields that refer to no
+	 * argument are omitted from the result.
+	 *
+	 * @param out the string to assign the result to
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @return the first error or @ref no_error
+	 */
+	template <typename... Args>
+	FMTG_INLINE error_code try_format(std::string& out, const internal::format_string& fmt, const Args&... args)
+	{
+		out.clear();
+		formatting::internal::string_buffer buffer(out);
+		buffer.reserve(fmt.length() + formatting::internal::estimateArguments(args...));
+		keep_error report;
+		formatting::internal::formatVariadic(buffer, fmt, report, args...);
+		buffer.finish();
+		return report.code_;
+	}
+
+	/** Constructs a string like by @ref format, the string
+	 * and its storage are allocated by the provided allocator.
+	 *
+	 * E.g. with an arena
+	 * 	ArenaAllocator<char> alloc(arena);
+	 * 	auto line = formatting::format(alloc, "{} is {}", "x", 42);
+	 *
+	 * @param allocator the allocator of chars to construct the string with
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @return new string of type std::basic_string<char, std::char_traits<char>, Allocator>
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters
+	 */
+	template <typename ErrorPolicy = throw_errors, typename Allocator, typename... Args>
+	FMTG_INLINE typename std::enable_if<
+		std::is_same<typename Allocator::value_type, char>::value && 
+		!std::is_convertible<Allocator, internal::format_string>::value,
+		std::basic_string<char, std::char_traits<char>, Allocator> >::type
+	format(const Allocator& allocator, const internal::format_string& fmt, const Args&... args)
+	{
+		typedef std::basic_string<char, std::char_traits<char>, Allocator> string;
+		string formatted(allocator);
+		formatting::internal::basic_string_buffer<string> buffer(formatted);
+		buffer.reserve(fmt.length() + formatting::internal::estimateArguments(args...));
+		ErrorPolicy report;
+		formatting::internal::formatVariadic(buffer, fmt, report, args...);
+		buffer.finish();
+		return formatted;
+	}
+
+#ifdef FMTG_USE_CXX17
+	/** Constructs a string like by @ref format, the string
+	 * is allocated from the provided memory resource.
+	 *
+	 * @param resource the memory resource to allocate the string from
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters
+	 */
+	template <typename ErrorPolicy = throw_errors, typename... Args>
+	FMTG_INLINE std::pmr::string format(std::pmr::memory_resource* resource, 
+	                                    const internal::format_string& fmt, const Args&... args)
+	{
+		return format<ErrorPolicy>(std::pmr::polymorphic_allocator<char>(resource), fmt, args...);
+	}
+#endif
+
+	/** Writes the string constructed like by @ref format
+	 * to the output iterator with no intermediate strings.
+	 * Writes directly to the memory if the iterator is char*.
+	 *
+	 * @param out the output iterator to write to
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @return the iterator past the last written character
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters
+	 */
+	template <typename ErrorPolicy = throw_errors, typename OutputIt, typename... Args>
+	FMTG_INLINE OutputIt format_to(OutputIt out, const internal::format_string& fmt, const Args&... args)
+	{
+		formatting::internal::iterator_buffer<OutputIt> buffer(out);
+		ErrorPolicy report;
+		formatting::internal::formatVariadic(buffer, fmt, report, args...);
+		return buffer.out();
 	}
 
+	/** Appends the string constructed like by @ref format
+	 * to the memory buffer.
+	 *
+	 * @param out the memory buffer to append to
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters
+	 */
+	template <typename ErrorPolicy = throw_errors, std::size_t N, typename Allocator, typename... Args>
+	FMTG_INLINE void format_to(basic_memory_buffer<N, Allocator>& out, const internal::format_string& fmt, const Args&... args)
+	{
+		out.reserve(fmt.length() + formatting::internal::estimateArguments(args...));
+		ErrorPolicy report;
+		formatting::internal::formatVariadic(out, fmt, report, args...);
+	}
+
+	/** Writes at most n characters of the string constructed 
+	 * like by @ref format to the provided memory, the rest is
+	 * truncated. No terminating null character is written.
+	 *
+	 * @param out the memory to write to
+	 * @param n the capacity of the memory
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @return the length of the whole string, it is greater than n
+	 *         in case the string was truncated
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters
+	 */
+	template <typename ErrorPolicy = throw_errors, typename... Args>
+	FMTG_INLINE std::size_t format_to_n(char* out, std::size_t n, const internal::format_string& fmt, const Args&... args)
+	{
+		formatting::internal::truncating_buffer buffer(out, n);
+		ErrorPolicy report;
+		formatting::internal::formatVariadic(buffer, fmt, report, args...);
+		return buffer.written();
+	}
+
+	/** Returns the length of the string constructed like by 
+	 * @ref format without constructing it.
+	 *
+	 * @param fmt the formatting string that contains {} placeholders.
+	 * @param args any variables which types have the stream insertion
+	 *        operator (operator<<) implemented.
+	 * @throw formatting_error in case the number of placeholders doesn't match
+	 *        the number of provided parameters
+	 */
+	template <typename ErrorPolicy = throw_errors, typename... Args>
+	FMTG_INLINE std::size_t formatted_size(const internal::format_string& fmt, const Args&... args)
+	{
+		formatting::internal::counting_buffer buffer;
+		ErrorPolicy report;
+		formatting::internal::formatVariadic(buffer, fmt, report, args...);
+		return buffer.written();
+	}
+#else
 	/** Constructs a string using the provided formatting string and
 	 * arguments. Essentially, replaces all placeholders ("{}") in the 
 	 * string with the corresponding string representations 
@@ -491,6 +1343,176 @@ namespace formatting
 		const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e, &f, &g, &h, &i, &j};
 		return formatting::internal::formatImplementation(fmt, handlers, 10);
 	}
+#endif
+
+	/** A formatting string that is parsed once into literal
+	 * segments and placeholders and then can be applied to
+	 * arguments many times without scanning the string again.
+	 *
+	 * The number of arguments is a part of the type: the
+	 * mismatch with the number of placeholders is reported
+	 * by the constructor and calling with a wrong number of
+	 * arguments doesn't compile.
+	 *
+	 * E.g.
+	 * 	static const formatting::compiled_format<2> line("{} is {}");
+	 * 	line("x", 42); // => 'x is 42'
+	 */
+	template <std::size_t N>
+	class compiled_format
+	{
+	public:
+		/** Parses the formatting string.
+		 *
+		 * @param fmt the formatting string that contains N {} placeholders.
+		 * @throw formatting_error in case the number of placeholders doesn't match N,
+		 *        a field has a format spec that can't be parsed or {} fields
+		 *        are mixed with {n} ones
+		 */
+		explicit compiled_format(const std::string& fmt) :
+			parsed_(fmt)
+		{
+			if (parsed_.automatic_only() ? parsed_.n_fields() != N : parsed_.n_arguments() > N)
+				throw formatting_error("The number of placeholders doesn't match the number of provided arguments");
+			for (std::size_t i=0; i<parsed_.n_fields(); i++)
+			{
+				if (parsed_.field_at(i).invalid_spec_)
+					throw formatting_error(error_message(invalid_spec));
+				if (parsed_.field_at(i).mixed_indexing_)
+					throw formatting_error(error_message(mixed_indexing));
+			}
+		}
+
+#ifdef FMTG_USE_CXX11
+		template <typename... Args>
+		FMTG_INLINE std::string operator()(const Args&... args) const
+		{
+			static_assert(sizeof...(Args) == N,
+				"The number of placeholders doesn't match the number of provided arguments");
+			std::string formatted;
+			internal::string_buffer buffer(formatted);
+			parsed_.apply(buffer, args...);
+			buffer.finish();
+			return formatted;
+		}
+		/** Appends the result to the memory buffer. */
+		template <std::size_t M, typename Allocator, typename... Args>
+		FMTG_INLINE void format_to(basic_memory_buffer<M, Allocator>& out, const Args&... args) const
+		{
+			static_assert(sizeof...(Args) == N,
+				"The number of placeholders doesn't match the number of provided arguments");
+			parsed_.apply(out, args...);
+		}
+#else
+		FMTG_INLINE std::string operator()(const ValueWrapper& a) const
+		{
+			utils::compile_time_assert<N == 1> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b) const
+		{
+			utils::compile_time_assert<N == 2> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c) const
+		{
+			utils::compile_time_assert<N == 3> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d) const
+		{
+			utils::compile_time_assert<N == 4> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d,
+				const ValueWrapper& e) const
+		{
+			utils::compile_time_assert<N == 5> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d,
+				const ValueWrapper& e, const ValueWrapper& f) const
+		{
+			utils::compile_time_assert<N == 6> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e, &f};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d,
+				const ValueWrapper& e, const ValueWrapper& f,
+				const ValueWrapper& g) const
+		{
+			utils::compile_time_assert<N == 7> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e, &f, &g};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d,
+				const ValueWrapper& e, const ValueWrapper& f,
+				const ValueWrapper& g, const ValueWrapper& h) const
+		{
+			utils::compile_time_assert<N == 8> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e, &f, &g, &h};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d,
+				const ValueWrapper& e, const ValueWrapper& f,
+				const ValueWrapper& g, const ValueWrapper& h,
+				const ValueWrapper& i) const
+		{
+			utils::compile_time_assert<N == 9> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e, &f, &g, &h, &i};
+			return apply(handlers);
+		}
+		FMTG_INLINE std::string operator()(const ValueWrapper& a, const ValueWrapper& b,
+				const ValueWrapper& c, const ValueWrapper& d,
+				const ValueWrapper& e, const ValueWrapper& f,
+				const ValueWrapper& g, const ValueWrapper& h,
+				const ValueWrapper& i, const ValueWrapper& j) const
+		{
+			utils::compile_time_assert<N == 10> WRONG_NUMBER_OF_ARGUMENTS;
+			(void)WRONG_NUMBER_OF_ARGUMENTS;
+			const ValueWrapper* handlers[] = {&a, &b, &c, &d, &e, &f, &g, &h, &i, &j};
+			return apply(handlers);
+		}
+#endif
+	private:
+#ifndef FMTG_USE_CXX11
+		FMTG_INLINE std::string apply(const ValueWrapper** handlers) const
+		{
+			std::string formatted;
+			internal::string_buffer buffer(formatted);
+			internal::rendered outputs[N];
+			parsed_.applyArguments(buffer, internal::wrapped_arguments(handlers, N), outputs);
+			buffer.finish();
+			return formatted;
+		}
+#endif
+		internal::parsed_format parsed_;
+	};
+
 
 }
+
+#include <formatting/cache.hpp>
+
 #endif
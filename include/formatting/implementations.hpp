@@ -31,40 +31,194 @@
 #define FORMATTING_IMPLEMENTATIONS_H_
 
 #include <vector>
+#include <deque>
+#include <list>
+#include <set>
+#include <map>
+#include <utility>
+#ifdef FMTG_USE_CXX11
+#include <array>
+#include <unordered_set>
+#include <unordered_map>
+#include <tuple>
+#endif
+#include <algorithm>
+#include <cstring>
 
 namespace formatting
 {
+	/** Formatter of values of type T to specialize for user types. 
+	 * Specializations append the representation to the buffer, 
+	 * e.g. with @ref write, and estimate its length.
+	 *
+	 * E.g.
+	 * 	namespace formatting
+	 * 	{
+	 * 		template <>
+	 * 		struct formatter<order_id>
+	 * 		{
+	 * 			void operator()(buffer& out, const order_id& id) const
+	 * 			{
+	 * 				out.push_back('#');
+	 * 				write(out, id.number);
+	 * 			}
+	 * 			std::size_t size_hint(const order_id&) const
+	 * 			{
+	 * 				return 12;
+	 * 			}
+	 * 		};
+	 * 	}
+	 *
+	 * Specializations take precedence over the representation of
+	 * types the library doesn't format itself (stream insertion
+	 * operators) as well as of numeric types. The primary template
+	 * is not a formatter.
+	 */
+	template <typename T>
+	struct formatter
+	{
+		typedef void default_formatter;
+	};
+
 	namespace internal
 	{
+		/** Type that is used to represent a value of type T,
+		 * arrays are represented as pointers to their elements. */
+		template <typename T>
+		struct decayed
+		{
+			typedef T type;
+		};
+		template <typename T, std::size_t N>
+		struct decayed<T[N]>
+		{
+			typedef const T* type;
+		};
+
 		namespace
 		{
+			/** Estimated length of representations that can't be
+			 * measured without converting the value. */
+			static const std::size_t default_size_hint = 16;
+
+			/** Stream buffer that passes the characters written to
+			 * a stream straight to the buffer. Traits are the template
+			 * parameter, so complete stream types are needed only
+			 * when some value is written by a stream. */
+			template <typename Traits>
+			class stream_adapter : public std::basic_streambuf<char, Traits>
+			{
+			public:
+				explicit stream_adapter(buffer& formatted) : 
+					formatted_(formatted)
+				{
+				}
+			protected:
+				typedef typename std::basic_streambuf<char, Traits>::int_type int_type;
+				virtual int_type overflow(int_type c)
+				{
+					if (!Traits::eq_int_type(c, Traits::eof()))
+						formatted_.push_back(Traits::to_char_type(c));
+					return Traits::not_eof(c);
+				}
+				virtual std::streamsize xsputn(const char* s, std::streamsize n)
+				{
+					formatted_.append(s, s + n);
+					return n;
+				}
+			private:
+				buffer& formatted_;
+			};
+
+			template <typename T>
+			struct streamed_traits
+			{
+				typedef std::char_traits<char> type;
+			};
+
+			/** Writes the value by its stream insertion operator,
+			 * used for types that have no other representation. */
+			template <typename T>
+			FMTG_INLINE void writeStreamed(buffer& formatted, const T& value)
+			{
+				typedef typename streamed_traits<T>::type traits;
+				stream_adapter<traits> adapter(formatted);
+				std::basic_ostream<char, traits> stream(&adapter);
+				stream << value;
+			}
+
+			/** Floating point numbers other than float and double
+			 * are written by streams. */
+			template <typename T>
+			FMTG_INLINE void writeFloatingPoint(buffer& formatted, const T& value)
+			{
+				writeStreamed(formatted, value);
+			}
+#ifdef FMTG_NO_IOSTREAM
+			/** Long doubles are written as doubles with no streams. */
+			FMTG_INLINE void writeFloatingPoint(buffer& formatted, long double value)
+			{
+				writeShortest(formatted, static_cast<double>(value));
+			}
+#endif
+			FMTG_INLINE void writeFloatingPoint(buffer& formatted, float value)
+			{
+				writeShortest(formatted, value);
+			}
+			FMTG_INLINE void writeFloatingPoint(buffer& formatted, double value)
+			{
+				writeShortest(formatted, value);
+			}
+
+			template <typename T, bool integer>
+			struct NumericIfInteger
+			{
+			};
+			template <typename T>
+			struct NumericIfInteger<T,true>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const T& value) const
+				{
+					writeInteger(formatted, value);
+				}
+				FMTG_INLINE std::size_t size_hint(const T& value) const
+				{
+					return integerSize(value);
+				}
+			};
+			template <typename T>
+			struct NumericIfInteger<T,false>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const T& value) const
+				{
+					writeFloatingPoint(formatted, value);
+				}
+				FMTG_INLINE std::size_t size_hint(const T&) const
+				{
+					// e.g. -2.2250738585072014e-308
+					return 24;
+				}
+			};
 
 			template <typename T, bool special> 
 			struct GenericIfSpecial
 			{
 			};
 			template <typename T> 
-			struct GenericIfSpecial<T,true>
+			struct GenericIfSpecial<T,true> : 
+				public NumericIfInteger<T,std::numeric_limits<T>::is_integer>
 			{
-				FMTG_INLINE std::string operator()(const T& value) const
-				{
-#ifdef FMTG_USE_CXX11
-					return std::to_string(value);
-#else
-					std::stringstream string_stream;
-					string_stream << value;
-					return string_stream.str();
-#endif
-				}
 			};
 			template <typename T> 
 			struct GenericIfSpecial<T,false>
 			{
-				FMTG_INLINE std::string operator()(const T& value) const
+				FMTG_INLINE void operator()(buffer& formatted, const T& value) const
 				{
-					std::stringstream string_stream;
-					string_stream << value;
-					return string_stream.str();
+					writeStreamed(formatted, value);
+				}
+				FMTG_INLINE std::size_t size_hint(const T&) const
+				{
+					return default_size_hint;
 				}
 			};
 
@@ -86,88 +240,590 @@ namespace formatting
 				               is_same<unsigned char, T>::value };
 			};
 
+			/** Tells if formatter<T> is specialized. */
+			template <typename T>
+			struct has_formatter
+			{
+				template <typename U>
+				static char test(typename U::default_formatter*);
+				template <typename U>
+				static long test(...);
+				enum { value = sizeof(test< formatting::formatter<T> >(0)) != 1 };
+			};
+
+			template <typename T, bool user>
+			struct UserIfFormatter
+			{
+			};
 			template <typename T>
-			struct dispatchImplementation
+			struct UserIfFormatter<T,true> : 
+				public formatting::formatter<T>
 			{
-				FMTG_INLINE std::string operator()(const T& value) const 
+			};
+			template <typename T>
+			struct UserIfFormatter<T,false> : 
+				public GenericIfSpecial<T,
+					std::numeric_limits<T>::is_specialized && 
+					!is_char<T>::value>
+			{
+			};
+
+			template <typename T>
+			struct dispatchImplementation : 
+				public UserIfFormatter<T, has_formatter<T>::value>
+			{
+			};
+			template <typename T>
+			struct unqualified
+			{
+				typedef T type;
+			};
+			template <typename T>
+			struct unqualified<const T>
+			{
+				typedef T type;
+			};
+
+			static const char element_separator[] = ", ";
+
+			/** Writes the marker of n omitted elements or characters. */
+			FMTG_INLINE void writeOmitted(buffer& formatted, std::size_t n)
+			{
+				static const char ellipsis[] = "\xE2\x80\xA6 (";
+				static const char more[] = " more)";
+				formatted.append(ellipsis, ellipsis + sizeof(ellipsis) - 1);
+				writeInteger(formatted, n);
+				formatted.append(more, more + sizeof(more) - 1);
+			}
+			static const std::size_t omitted_size_hint = 16;
+
+			/** Writes elements of containers. */
+			template <typename T>
+			struct elementWriter
+			{
+				typedef typename unqualified<T>::type element_type;
+				FMTG_INLINE void operator()(buffer& formatted, const T& value) const 
 				{
-					return GenericIfSpecial<T,
-						   std::numeric_limits<T>::is_specialized && 
-						   !is_char<T>::value 
-						>()(value);
+					dispatchImplementation<element_type>()(formatted, value);
+				}
+				FMTG_INLINE std::size_t size_hint(const T& value) const
+				{
+					return dispatchImplementation<element_type>().size_hint(value);
 				}
 			};
-			template <typename T>
-			struct dispatchImplementation< std::vector<T> >
+			/** Writes elements of associative containers as 'key: value'. */
+			template <typename K, typename V>
+			struct keyValueWriter
 			{
-				FMTG_INLINE std::string operator()(const std::vector<T>& vector_) const 
+				FMTG_INLINE void operator()(buffer& formatted, const std::pair<const K, V>& value) const 
 				{
-					std::stringstream string_stream;
-					string_stream << "[";
-					for (size_t i=0; i<vector_.size()-1; i++)
-						string_stream << vector_[i] << ", ";
-					string_stream << vector_[vector_.size()-1];
-					string_stream << "]";
-					return string_stream.str();
+					dispatchImplementation<K>()(formatted, value.first);
+					formatted.push_back(':');
+					formatted.push_back(' ');
+					dispatchImplementation<V>()(formatted, value.second);
 				}
+				FMTG_INLINE std::size_t size_hint(const std::pair<const K, V>& value) const
+				{
+					return 2 + dispatchImplementation<K>().size_hint(value.first) +
+					       dispatchImplementation<V>().size_hint(value.second);
+				}
+			};
+			/** Writes elements of the container one by one straight
+			 * to the output, separated by commas and enclosed in
+			 * the open and close characters. */
+			template <typename Container, typename Writer, char open, char close>
+			struct rangeImplementation
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const Container& container) const 
+				{
+					write(formatted, container, static_cast<std::size_t>(-1));
+				}
+				/** Writes at most limit elements followed by the
+				 * number of omitted elements if there are any. */
+				FMTG_INLINE void write(buffer& formatted, const Container& container, std::size_t limit) const
+				{
+					const Writer writer = Writer();
+					formatted.push_back(open);
+					std::size_t written = 0;
+					for (typename Container::const_iterator it = container.begin(); it != container.end(); ++it)
+					{
+						if (written != 0)
+							formatted.append(element_separator, element_separator + 2);
+						if (written == limit)
+						{
+							writeOmitted(formatted, container.size() - limit);
+							break;
+						}
+						writer(formatted, *it);
+						written++;
+					}
+					formatted.push_back(close);
+				}
+				/** Assumes all elements are as long as the first one. */
+				FMTG_INLINE std::size_t size_hint(const Container& container) const
+				{
+					return size_hint(container, static_cast<std::size_t>(-1));
+				}
+				FMTG_INLINE std::size_t size_hint(const Container& container, std::size_t limit) const
+				{
+					if (container.empty())
+						return 2;
+					const std::size_t n_elements = std::min(container.size(), limit);
+					const std::size_t omitted = n_elements < container.size() ? omitted_size_hint : 0;
+					return 2 + omitted + n_elements * (2 + Writer().size_hint(*container.begin()));
+				}
+			};
+
+			template <typename T, typename A>
+			struct dispatchImplementation< std::vector<T, A> > : 
+				public rangeImplementation<std::vector<T, A>, elementWriter<T>, '[', ']'>
+			{
+			};
+			template <typename T, typename A>
+			struct dispatchImplementation< std::deque<T, A> > : 
+				public rangeImplementation<std::deque<T, A>, elementWriter<T>, '[', ']'>
+			{
+			};
+			template <typename T, typename A>
+			struct dispatchImplementation< std::list<T, A> > : 
+				public rangeImplementation<std::list<T, A>, elementWriter<T>, '[', ']'>
+			{
 			};
+			template <typename T, typename C, typename A>
+			struct dispatchImplementation< std::set<T, C, A> > : 
+				public rangeImplementation<std::set<T, C, A>, elementWriter<T>, '{', '}'>
+			{
+			};
+			template <typename T, typename C, typename A>
+			struct dispatchImplementation< std::multiset<T, C, A> > : 
+				public rangeImplementation<std::multiset<T, C, A>, elementWriter<T>, '{', '}'>
+			{
+			};
+			template <typename K, typename V, typename C, typename A>
+			struct dispatchImplementation< std::map<K, V, C, A> > : 
+				public rangeImplementation<std::map<K, V, C, A>, keyValueWriter<K, V>, '{', '}'>
+			{
+			};
+			template <typename K, typename V, typename C, typename A>
+			struct dispatchImplementation< std::multimap<K, V, C, A> > : 
+				public rangeImplementation<std::multimap<K, V, C, A>, keyValueWriter<K, V>, '{', '}'>
+			{
+			};
+			template <typename T1, typename T2>
+			struct dispatchImplementation< std::pair<T1, T2> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const std::pair<T1, T2>& value) const 
+				{
+					formatted.push_back('(');
+					elementWriter<T1>()(formatted, value.first);
+					formatted.append(element_separator, element_separator + 2);
+					elementWriter<T2>()(formatted, value.second);
+					formatted.push_back(')');
+				}
+				FMTG_INLINE std::size_t size_hint(const std::pair<T1, T2>& value) const
+				{
+					return 4 + elementWriter<T1>().size_hint(value.first) + 
+					       elementWriter<T2>().size_hint(value.second);
+				}
+			};
+#ifdef FMTG_USE_CXX11
+			template <typename T, std::size_t N>
+			struct dispatchImplementation< std::array<T, N> > : 
+				public rangeImplementation<std::array<T, N>, elementWriter<T>, '[', ']'>
+			{
+			};
+			template <typename T, typename H, typename E, typename A>
+			struct dispatchImplementation< std::unordered_set<T, H, E, A> > : 
+				public rangeImplementation<std::unordered_set<T, H, E, A>, elementWriter<T>, '{', '}'>
+			{
+			};
+			template <typename K, typename V, typename H, typename E, typename A>
+			struct dispatchImplementation< std::unordered_map<K, V, H, E, A> > : 
+				public rangeImplementation<std::unordered_map<K, V, H, E, A>, keyValueWriter<K, V>, '{', '}'>
+			{
+			};
+
+			/** Writes elements of the tuple starting from I. */
+			template <std::size_t I, std::size_t N>
+			struct tupleWriter
+			{
+				template <typename Tuple>
+				FMTG_INLINE void operator()(buffer& formatted, const Tuple& value) const
+				{
+					typedef typename std::remove_reference<typename std::tuple_element<I, Tuple>::type>::type element_type;
+					if (I != 0)
+						formatted.append(element_separator, element_separator + 2);
+					elementWriter<element_type>()(formatted, std::get<I>(value));
+					tupleWriter<I+1, N>()(formatted, value);
+				}
+				template <typename Tuple>
+				FMTG_INLINE std::size_t size_hint(const Tuple& value) const
+				{
+					typedef typename std::remove_reference<typename std::tuple_element<I, Tuple>::type>::type element_type;
+					return 2 + elementWriter<element_type>().size_hint(std::get<I>(value)) + 
+					       tupleWriter<I+1, N>().size_hint(value);
+				}
+			};
+			template <std::size_t N>
+			struct tupleWriter<N, N>
+			{
+				template <typename Tuple>
+				FMTG_INLINE void operator()(buffer&, const Tuple&) const
+				{
+				}
+				template <typename Tuple>
+				FMTG_INLINE std::size_t size_hint(const Tuple&) const
+				{
+					return 0;
+				}
+			};
+			template <typename... Ts>
+			struct dispatchImplementation< std::tuple<Ts...> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const std::tuple<Ts...>& value) const 
+				{
+					formatted.push_back('(');
+					tupleWriter<0, sizeof...(Ts)>()(formatted, value);
+					formatted.push_back(')');
+				}
+				FMTG_INLINE std::size_t size_hint(const std::tuple<Ts...>& value) const
+				{
+					return 2 + tupleWriter<0, sizeof...(Ts)>().size_hint(value);
+				}
+			};
+#endif
 			template <typename T>
 			struct dispatchImplementation<T*>
 			{
-				FMTG_INLINE std::string operator()(T* value) const 
+				typedef typename unqualified<T>::type value_type;
+				FMTG_INLINE void operator()(buffer& formatted, T* value) const 
+				{
+					dispatchImplementation<value_type>()(formatted, *value);
+				}
+				FMTG_INLINE std::size_t size_hint(T* value) const
+				{
+					return dispatchImplementation<value_type>().size_hint(*value);
+				}
+			};
+			template <typename T>
+			struct dispatchImplementation< wrappers::HexWrapper<T> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::HexWrapper<T>& wrapper) const 
+				{
+					writePowerOf2<4>(formatted, wrapper.value_, "0x", 2);
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::HexWrapper<T>& wrapper) const
+				{
+					typedef typename unsigned_of<T>::type U;
+					return 2 + countPowerOf2Digits<4>(static_cast<U>(wrapper.value_));
+				}
+			};
+			template <typename T>
+			struct dispatchImplementation< wrappers::OctWrapper<T> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::OctWrapper<T>& wrapper) const 
+				{
+					writePowerOf2<3>(formatted, wrapper.value_, "0", 1);
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::OctWrapper<T>& wrapper) const
+				{
+					typedef typename unsigned_of<T>::type U;
+					return 1 + countPowerOf2Digits<3>(static_cast<U>(wrapper.value_));
+				}
+			};
+			/** Pads the representation of any value including other
+			 * wrappers. The value is written once into the stack
+			 * buffer, then the fill characters and the copy of it. */
+			template <typename T>
+			struct dispatchImplementation< wrappers::WidthWrapper<T> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::WidthWrapper<T>& wrapper) const 
+				{
+					basic_memory_buffer<64> rendered;
+					dispatchImplementation<T>()(rendered, wrapper.value_);
+					for (std::size_t i=rendered.size(); i<wrapper.width_; i++)
+						formatted.push_back(wrapper.filler_);
+					formatted.append(rendered.begin(), rendered.end());
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::WidthWrapper<T>& wrapper) const
+				{
+					return std::max<std::size_t>(wrapper.width_, dispatchImplementation<T>().size_hint(wrapper.value_));
+				}
+			};
+			template <typename T>
+			struct dispatchImplementation< wrappers::PrecisionWrapper<T> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::PrecisionWrapper<T>& wrapper) const 
+				{
+					writeWithPrecision(formatted, wrapper.value_, wrapper.precision_);
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::PrecisionWrapper<T>& wrapper) const
+				{
+					return wrapper.precision_ + 8;
+				}
+			private:
+				/** Integers are not affected by the precision. */
+				template <typename U>
+				static FMTG_INLINE void writeWithPrecision(buffer& formatted, const U& value, unsigned int)
+				{
+					dispatchImplementation<U>()(formatted, value);
+				}
+				static FMTG_INLINE void writeWithPrecision(buffer& formatted, float value, unsigned int precision)
+				{
+					writePrecision(formatted, value, precision);
+				}
+				static FMTG_INLINE void writeWithPrecision(buffer& formatted, double value, unsigned int precision)
+				{
+					writePrecision(formatted, value, precision);
+				}
+				static FMTG_INLINE void writeWithPrecision(buffer& formatted, long double value, unsigned int precision)
+				{
+#ifdef FMTG_NO_IOSTREAM
+					writePrecision(formatted, static_cast<double>(value), precision);
+#else
+					stream_adapter< std::char_traits<char> > adapter(formatted);
+					std::ostream stream(&adapter);
+					stream.precision(precision);
+					stream << value;
+#endif
+				}
+			};
+			template <typename T>
+			struct dispatchImplementation< wrappers::NamedWrapper<T> >
+			{
+				typedef typename decayed<T>::type value_type;
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::NamedWrapper<T>& wrapper) const 
+				{
+					dispatchImplementation<value_type>()(formatted, wrapper.value_);
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::NamedWrapper<T>& wrapper) const
+				{
+					return dispatchImplementation<value_type>().size_hint(wrapper.value_);
+				}
+			};
+			/** Writes containers that are represented
+			 * by @ref rangeImplementation. */
+			template <typename T>
+			struct dispatchImplementation< wrappers::LimitWrapper<T> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::LimitWrapper<T>& wrapper) const 
+				{
+					dispatchImplementation<T>().write(formatted, wrapper.value_, wrapper.limit_);
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::LimitWrapper<T>& wrapper) const
+				{
+					return dispatchImplementation<T>().size_hint(wrapper.value_, wrapper.limit_);
+				}
+			};
+
+			FMTG_INLINE void getCharacters(const std::string& value, const char*& data, std::size_t& length)
+			{
+				data = value.data();
+				length = value.length();
+			}
+			FMTG_INLINE void getCharacters(const char* value, const char*& data, std::size_t& length)
+			{
+				data = value;
+				length = std::strlen(value);
+			}
+#ifdef FMTG_USE_CXX17
+			FMTG_INLINE void getCharacters(std::string_view value, const char*& data, std::size_t& length)
+			{
+				data = value.data();
+				length = value.length();
+			}
+#endif
+			/** Returns the length of the prefix of at most n
+			 * characters that doesn't split UTF-8 sequences. */
+			FMTG_INLINE std::size_t utf8Prefix(const char* data, std::size_t length, std::size_t n)
+			{
+				if (n >= length)
+					return length;
+				while (n > 0 && (static_cast<unsigned char>(data[n]) & 0xC0) == 0x80)
+					n--;
+				return n;
+			}
+			template <typename T>
+			struct dispatchImplementation< wrappers::TruncateWrapper<T> >
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const wrappers::TruncateWrapper<T>& wrapper) const 
+				{
+					const char* data;
+					std::size_t length;
+					getCharacters(wrapper.value_, data, length);
+					const std::size_t prefix = utf8Prefix(data, length, wrapper.length_);
+					formatted.append(data, data + prefix);
+					if (prefix < length)
+						writeOmitted(formatted, length - prefix);
+				}
+				FMTG_INLINE std::size_t size_hint(const wrappers::TruncateWrapper<T>& wrapper) const
 				{
-					std::stringstream string_stream;
-					string_stream << *value;
-					return string_stream.str();
+					return wrapper.length_ + omitted_size_hint;
 				}
 			};
 			template <>
 			struct dispatchImplementation<std::string>
 			{
-				FMTG_INLINE std::string operator()(const std::string& value) const 
+				FMTG_INLINE void operator()(buffer& formatted, const std::string& value) const 
+				{
+					formatted.append(value);
+				}
+				FMTG_INLINE std::size_t size_hint(const std::string& value) const
 				{
-					return value;
+					return value.length();
 				}
 			};
 			template <>
 			struct dispatchImplementation<const char*>
 			{
-				FMTG_INLINE std::string operator()(const char* const value) const 
+				FMTG_INLINE void operator()(buffer& formatted, const char* const value) const 
 				{
-					return value;
+					formatted.append(value, value + std::strlen(value));
 				}
+				FMTG_INLINE std::size_t size_hint(const char* const value) const
+				{
+					return std::strlen(value);
+				}
+			};
+			template <>
+			struct dispatchImplementation<char*> : dispatchImplementation<const char*>
+			{
+			};
+#ifdef FMTG_USE_CXX17
+			template <>
+			struct dispatchImplementation<std::string_view>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, std::string_view value) const 
+				{
+					formatted.append(value.data(), value.data() + value.length());
+				}
+				FMTG_INLINE std::size_t size_hint(std::string_view value) const
+				{
+					return value.length();
+				}
+			};
+#endif
+			/** Writes characters as they are. */
+			template <typename T>
+			struct characterImplementation
+			{
+				FMTG_INLINE void operator()(buffer& formatted, T value) const 
+				{
+					formatted.push_back(static_cast<char>(value));
+				}
+				FMTG_INLINE std::size_t size_hint(T) const
+				{
+					return 1;
+				}
+			};
+			template <>
+			struct dispatchImplementation<char> : characterImplementation<char>
+			{
+			};
+			template <>
+			struct dispatchImplementation<signed char> : characterImplementation<signed char>
+			{
+			};
+			template <>
+			struct dispatchImplementation<unsigned char> : characterImplementation<unsigned char>
+			{
 			};
 			template <>
 			struct dispatchImplementation<bool>
 			{
-				FMTG_INLINE std::string operator()(bool value) const 
+				FMTG_INLINE void operator()(buffer& formatted, bool value) const 
+				{
+					static const char true_[] = "true";
+					static const char false_[] = "false";
+					if (value)
+						formatted.append(true_, true_ + sizeof(true_) - 1);
+					else
+						formatted.append(false_, false_ + sizeof(false_) - 1);
+				}
+				FMTG_INLINE std::size_t size_hint(bool) const
 				{
-					return value ? "true" : "false";
+					return 5;
 				}
 			};
 		}
 
-		class ValueWrapperImplementationBase
+		/** Appends the representation of the value to formatted. */
+		template <typename T>
+		FMTG_INLINE void writeArgument(buffer& formatted, const T& value)
 		{
-		public:
-			virtual ~ValueWrapperImplementationBase() { }
-			virtual std::string representation() const = 0;
-		};
+			typedef typename decayed<T>::type value_type;
+			dispatchImplementation<value_type>()(formatted, value);
+		}
 
+		/** Returns the estimated length of the value representation,
+		 * it is exact for strings. */
 		template <typename T>
-		class ValueWrapperImplementation : 
-			public ValueWrapperImplementationBase
+		FMTG_INLINE std::size_t estimateArgument(const T& value)
 		{
-		public:
-			ValueWrapperImplementation(const T& value) :
-				value_(value) { }
-			FMTG_INLINE virtual std::string representation() const 
-			{
-				return dispatchImplementation<T>()(value_);
-			}
-		private:
-			const T value_;
-		};
+			typedef typename decayed<T>::type value_type;
+			return dispatchImplementation<value_type>().size_hint(value);
+		}
+
+		/** Returns the name given to the argument 
+		 * by @ref formatting::arg or NULL. */
+		template <typename T>
+		FMTG_INLINE const char* argumentName(const T&)
+		{
+			return NULL;
+		}
+		template <typename T>
+		FMTG_INLINE const char* argumentName(const wrappers::NamedWrapper<T>& value)
+		{
+			return value.name_;
+		}
+
+		/** Writer that is used by @ref ValueWrapper.
+		 * Appends the representation of the value of type T
+		 * pointed by value to formatted. */
+		template <typename T>
+		void writeValue(buffer& formatted, const void* value)
+		{
+			writeArgument(formatted, *static_cast<const T*>(value));
+		}
+
+#ifdef FMTG_USE_CXX11
+		FMTG_INLINE std::size_t estimateArguments()
+		{
+			return 0;
+		}
+		/** Returns the sum of estimated lengths of arguments. */
+		template <typename T, typename... Rest>
+		FMTG_INLINE std::size_t estimateArguments(const T& value, const Rest&... rest)
+		{
+			return estimateArgument(value) + estimateArguments(rest...);
+		}
+#endif
+
+		/** Estimator that is used by @ref ValueWrapper. */
+		template <typename T>
+		std::size_t estimateValue(const void* value)
+		{
+			return estimateArgument(*static_cast<const T*>(value));
+		}
+
+		/** Writer of the default constructed @ref ValueWrapper. */
+		inline void writeInvalidArgument(buffer& formatted, const void*)
+		{
+			static const char text[] = "invalid argument";
+			formatted.append(text, text + sizeof(text) - 1);
+		}
+		inline std::size_t estimateInvalidArgument(const void*)
+		{
+			return 16;
+		}
+	}
+
+	/** Appends the representation of the value to the buffer,
+	 * to be used by @ref formatter specializations. */
+	template <typename T>
+	FMTG_INLINE void write(buffer& out, const T& value)
+	{
+		internal::writeArgument(out, value);
 	}
 }
 #endif
@@ -0,0 +1,224 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_LOG_H_
+#define FORMATTING_LOG_H_
+
+#include <formatting/formatting.hpp>
+
+#ifdef FMTG_USE_CXX11
+
+#include <atomic>
+#include <cstdio>
+
+#define FMTG_LOG_TRACE 0
+#define FMTG_LOG_DEBUG 1
+#define FMTG_LOG_INFO 2
+#define FMTG_LOG_WARNING 3
+#define FMTG_LOG_ERROR 4
+#define FMTG_LOG_OFF 5
+
+/** Define FMTG_LOG_MIN_LEVEL before the include to compile out log 
+ * statements below the level, e.g. -DFMTG_LOG_MIN_LEVEL=FMTG_LOG_INFO
+ * removes trace and debug statements from release builds. */
+#ifndef FMTG_LOG_MIN_LEVEL
+	#define FMTG_LOG_MIN_LEVEL FMTG_LOG_TRACE
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define FMTG_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+	#define FMTG_UNLIKELY(condition) (condition)
+#endif
+
+/** Formats and writes the line if the level is enabled. The arguments
+ * are not evaluated when it is not: the statement is a single load
+ * of the runtime level and a branch, and levels below 
+ * FMTG_LOG_MIN_LEVEL are folded out by the compiler. The level is
+ * evaluated once.
+ *
+ * E.g. FMTG_LOG_IF(formatting::debug_level, "{} items", expensive())
+ *
+ * @param level the level of the statement
+ */
+#define FMTG_LOG_IF(level, ...) \
+	do \
+	{ \
+		const int fmtg_log_level = (level); \
+		if (fmtg_log_level >= FMTG_LOG_MIN_LEVEL && FMTG_UNLIKELY(formatting::log_enabled(fmtg_log_level))) \
+			formatting::log_write(fmtg_log_level, __VA_ARGS__); \
+	} \
+	while (false)
+
+/** Statements of fixed levels, the ones below FMTG_LOG_MIN_LEVEL 
+ * are removed by the preprocessor. */
+#if FMTG_LOG_MIN_LEVEL <= FMTG_LOG_TRACE
+	#define FMTG_TRACE(...) FMTG_LOG_IF(formatting::trace_level, __VA_ARGS__)
+#else
+	#define FMTG_TRACE(...) do { } while (false)
+#endif
+#if FMTG_LOG_MIN_LEVEL <= FMTG_LOG_DEBUG
+	#define FMTG_DEBUG(...) FMTG_LOG_IF(formatting::debug_level, __VA_ARGS__)
+#else
+	#define FMTG_DEBUG(...) do { } while (false)
+#endif
+#if FMTG_LOG_MIN_LEVEL <= FMTG_LOG_INFO
+	#define FMTG_INFO(...) FMTG_LOG_IF(formatting::info_level, __VA_ARGS__)
+#else
+	#define FMTG_INFO(...) do { } while (false)
+#endif
+#if FMTG_LOG_MIN_LEVEL <= FMTG_LOG_WARNING
+	#define FMTG_WARNING(...) FMTG_LOG_IF(formatting::warning_level, __VA_ARGS__)
+#else
+	#define FMTG_WARNING(...) do { } while (false)
+#endif
+#if FMTG_LOG_MIN_LEVEL <= FMTG_LOG_ERROR
+	#define FMTG_ERROR(...) FMTG_LOG_IF(formatting::error_level, __VA_ARGS__)
+#else
+	#define FMTG_ERROR(...) do { } while (false)
+#endif
+
+namespace formatting
+{
+	enum log_level
+	{
+		trace_level = FMTG_LOG_TRACE,
+		debug_level = FMTG_LOG_DEBUG,
+		info_level = FMTG_LOG_INFO,
+		warning_level = FMTG_LOG_WARNING,
+		error_level = FMTG_LOG_ERROR,
+		/** Disables all statements. */
+		off_level = FMTG_LOG_OFF
+	};
+
+	/** Function that takes formatted lines with the newline. */
+	typedef void (*log_writer)(log_level level, const char* line, std::size_t length);
+
+	namespace internal
+	{
+		FMTG_INLINE void writeLogLine(log_level, const char* line, std::size_t length)
+		{
+			fwrite(line, 1, length, stderr);
+		}
+
+		/** Runtime state of logging, a template to be defined in the header. */
+		template <typename T = void>
+		struct log_state
+		{
+			static std::atomic<int> level_;
+			static std::atomic<log_writer> writer_;
+		};
+		template <typename T>
+		std::atomic<int> log_state<T>::level_(FMTG_LOG_INFO);
+		template <typename T>
+		std::atomic<log_writer> log_state<T>::writer_(&writeLogLine);
+
+		/** Line buffer of the thread that all statements share and
+		 * the flag that is set while a statement uses it. */
+		struct thread_log_line
+		{
+			thread_log_line() :
+				buffer_(), busy_(false)
+			{
+			}
+			memory_buffer buffer_;
+			bool busy_;
+		};
+		FMTG_INLINE thread_log_line& threadLogLine()
+		{
+			thread_local thread_log_line line;
+			return line;
+		}
+
+		template <typename... Args>
+		FMTG_INLINE void formatLogLine(memory_buffer& line, int level, const format_string& fmt, const Args&... args)
+		{
+			line.clear();
+			mark_errors report;
+			formatVariadic(line, fmt, report, args...);
+			line.push_back('\n');
+			log_writer writer = log_state<>::writer_.load(std::memory_order_acquire);
+			writer(static_cast<log_level>(level), line.data(), line.size());
+		}
+	}
+
+	/** Enables statements of the level and above, info by default. */
+	FMTG_INLINE void set_log_level(log_level level)
+	{
+		internal::log_state<>::level_.store(level, std::memory_order_relaxed);
+	}
+	FMTG_INLINE log_level get_log_level()
+	{
+		return static_cast<log_level>(internal::log_state<>::level_.load(std::memory_order_relaxed));
+	}
+	/** Returns true if statements of the level are written. */
+	FMTG_INLINE bool log_enabled(int level)
+	{
+		return level >= internal::log_state<>::level_.load(std::memory_order_relaxed);
+	}
+	/** Sets the function that writes lines, they go to stderr by default. */
+	FMTG_INLINE void set_log_writer(log_writer writer)
+	{
+		internal::log_state<>::writer_.store(writer, std::memory_order_release);
+	}
+
+	/** Formats the line into a per-thread buffer and passes it to the 
+	 * writer. Errors of the formatting string are marked like by 
+	 * @ref mark_errors, a log statement doesn't throw them. 
+	 *
+	 * A statement reached while the line of the thread is being
+	 * formatted or written, e.g. by a formatter of an argument,
+	 * uses a buffer of its own. */
+	template <typename... Args>
+	FMTG_INLINE void log_write(int level, const internal::format_string& fmt, const Args&... args)
+	{
+		internal::thread_log_line& line = internal::threadLogLine();
+		if (line.busy_)
+		{
+			memory_buffer nested;
+			internal::formatLogLine(nested, level, fmt, args...);
+			return;
+		}
+		line.busy_ = true;
+		try
+		{
+			internal::formatLogLine(line.buffer_, level, fmt, args...);
+		}
+		catch (...)
+		{
+			line.busy_ = false;
+			throw;
+		}
+		line.busy_ = false;
+	}
+}
+
+#endif
+#endif
@@ -0,0 +1,221 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FORMATTING_NUMBERS_H_
+#define FORMATTING_NUMBERS_H_
+
+#include <limits>
+#include <cstring>
+
+namespace formatting
+{
+	namespace internal
+	{
+		/** Unsigned type that holds the absolute value of T. */
+		template <typename T> struct unsigned_of { };
+		template <> struct unsigned_of<bool> { typedef unsigned char type; };
+		template <> struct unsigned_of<char> { typedef unsigned char type; };
+		template <> struct unsigned_of<signed char> { typedef unsigned char type; };
+		template <> struct unsigned_of<unsigned char> { typedef unsigned char type; };
+		template <> struct unsigned_of<short> { typedef unsigned short type; };
+		template <> struct unsigned_of<unsigned short> { typedef unsigned short type; };
+		template <> struct unsigned_of<int> { typedef unsigned int type; };
+		template <> struct unsigned_of<unsigned int> { typedef unsigned int type; };
+		template <> struct unsigned_of<long> { typedef unsigned long type; };
+		template <> struct unsigned_of<unsigned long> { typedef unsigned long type; };
+		template <> struct unsigned_of<long long> { typedef unsigned long long type; };
+		template <> struct unsigned_of<unsigned long long> { typedef unsigned long long type; };
+		/** Unsigned type of the size in bytes, for character types
+		 * which size and signedness depend on the platform. */
+		template <std::size_t Size> struct unsigned_of_size { };
+		template <> struct unsigned_of_size<1> { typedef unsigned char type; };
+		template <> struct unsigned_of_size<2> { typedef unsigned short type; };
+		template <> struct unsigned_of_size<4> { typedef unsigned int type; };
+		template <> struct unsigned_of_size<8> { typedef unsigned long long type; };
+		template <> struct unsigned_of<wchar_t> : unsigned_of_size<sizeof(wchar_t)> { };
+#ifdef FMTG_USE_CXX11
+		template <> struct unsigned_of<char16_t> : unsigned_of_size<sizeof(char16_t)> { };
+		template <> struct unsigned_of<char32_t> : unsigned_of_size<sizeof(char32_t)> { };
+#endif
+
+		/** Pairs of decimal digits of numbers from 0 to 99. */
+		static const char decimal_digit_pairs[] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+
+		/** Returns the number of decimal digits of the value. */
+		FMTG_INLINE int countDigits(unsigned long long value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			static const unsigned long long powers_of_10[] =
+			{
+				0ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+				10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+				100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+				100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+				100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+			};
+			// log10(2) is approximated by 1233/4096
+			const int t = (64 - __builtin_clzll(value | 1)) * 1233 >> 12;
+			return t - (value < powers_of_10[t]) + 1;
+#else
+			int n_digits = 1;
+			for (;;)
+			{
+				if (value < 10) return n_digits;
+				if (value < 100) return n_digits + 1;
+				if (value < 1000) return n_digits + 2;
+				if (value < 10000) return n_digits + 3;
+				value /= 10000;
+				n_digits += 4;
+			}
+#endif
+		}
+
+		/** Writes decimal digits of the value two at a time backwards
+		 * from end and returns the pointer to the first digit. */
+		template <typename U>
+		FMTG_INLINE char* formatDecimal(char* end, U value)
+		{
+			while (value >= 100)
+			{
+				const unsigned int index = static_cast<unsigned int>(value % 100) * 2;
+				value /= 100;
+				*--end = decimal_digit_pairs[index + 1];
+				*--end = decimal_digit_pairs[index];
+			}
+			if (value < 10)
+			{
+				*--end = static_cast<char>('0' + value);
+				return end;
+			}
+			const unsigned int index = static_cast<unsigned int>(value) * 2;
+			*--end = decimal_digit_pairs[index + 1];
+			*--end = decimal_digit_pairs[index];
+			return end;
+		}
+
+		template <typename T>
+		FMTG_INLINE bool isNegative(T value)
+		{
+			return std::numeric_limits<T>::is_signed && value < T();
+		}
+
+		template <typename T>
+		FMTG_INLINE typename unsigned_of<T>::type absoluteValue(T value)
+		{
+			typedef typename unsigned_of<T>::type U;
+			return isNegative(value) ? static_cast<U>(0 - static_cast<U>(value)) : static_cast<U>(value);
+		}
+
+		/** Returns the exact length of the decimal representation. */
+		template <typename T>
+		FMTG_INLINE std::size_t integerSize(T value)
+		{
+			return countDigits(absoluteValue(value)) + (isNegative(value) ? 1 : 0);
+		}
+
+		/** Writes the decimal representation of the integer
+		 * straight to the buffer. */
+		template <typename T>
+		FMTG_INLINE void writeInteger(buffer& formatted, T value)
+		{
+			const typename unsigned_of<T>::type absolute = absoluteValue(value);
+			const bool negative = isNegative(value);
+			const std::size_t length = countDigits(absolute) + (negative ? 1 : 0);
+			char* out = formatted.reserveContiguous(length);
+			if (out)
+			{
+				char* begin = formatDecimal(out + length, absolute);
+				if (negative)
+					*--begin = '-';
+				formatted.commit(length);
+			}
+			else
+			{
+				char digits[std::numeric_limits<unsigned long long>::digits10 + 2];
+				char* end = digits + sizeof(digits);
+				char* begin = formatDecimal(end, absolute);
+				if (negative)
+					*--begin = '-';
+				formatted.append(begin, end);
+			}
+		}
+
+		/** Writes digits of the value in the base 2^bits backwards
+		 * from end and returns the pointer to the first digit. */
+		template <int bits, typename U>
+		FMTG_INLINE char* formatPowerOf2(char* end, U value, bool lowercase = false)
+		{
+			static const char uppercase_digits[] = "0123456789ABCDEF";
+			static const char lowercase_digits[] = "0123456789abcdef";
+			const char* digits = lowercase ? lowercase_digits : uppercase_digits;
+			do
+			{
+				*--end = digits[static_cast<unsigned int>(value) & ((1 << bits) - 1)];
+				value >>= bits;
+			}
+			while (value);
+			return end;
+		}
+
+		/** Returns the number of digits of the value in the base 2^bits. */
+		template <int bits, typename U>
+		FMTG_INLINE std::size_t countPowerOf2Digits(U value)
+		{
+			std::size_t n_digits = 1;
+			while (value >>= bits)
+				n_digits++;
+			return n_digits;
+		}
+
+		/** Writes the prefix and digits of the two's complement
+		 * representation of the integer in the base 2^bits. */
+		template <int bits, typename T>
+		FMTG_INLINE void writePowerOf2(buffer& formatted, T value, const char* prefix, std::size_t prefix_length)
+		{
+			typedef typename unsigned_of<T>::type U;
+			char characters[sizeof(U) * 8 + 4];
+			char* end = characters + sizeof(characters);
+			char* begin = formatPowerOf2<bits>(end, static_cast<U>(value));
+			begin -= prefix_length;
+			std::memcpy(begin, prefix, prefix_length);
+			formatted.append(begin, end);
+		}
+	}
+}
+#endif
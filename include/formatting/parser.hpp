@@ -0,0 +1,451 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_PARSER_H_
+#define FORMATTING_PARSER_H_
+
+#include <algorithm>
+#include <cstring>
+
+/** Braces are searched with AVX2 if the compiler targets it or, 
+ * with GCC and Clang, if the processor supports it, otherwise with 
+ * SSE2 of x86-64. Define FMTG_NO_SIMD to use the portable loop. */
+#ifndef FMTG_NO_SIMD
+	#if defined(__AVX2__)
+		#define FMTG_SIMD_AVX2
+		#include <immintrin.h>
+	#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define FMTG_SIMD_SSE2
+		#include <emmintrin.h>
+		#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+			#define FMTG_SIMD_AVX2_DISPATCH
+			#include <immintrin.h>
+		#endif
+	#endif
+	#if defined(_MSC_VER) && (defined(FMTG_SIMD_AVX2) || defined(FMTG_SIMD_SSE2))
+		#include <intrin.h>
+	#endif
+#endif
+
+namespace formatting
+{
+	namespace internal
+	{
+		/** Format specification that follows a colon in the field,
+		 * [[fill]align][sign][#][0][width][.precision][type] where
+		 * align is one of <>^=, sign is one of +- and space and type
+		 * is one of dxXob for integers, eEfFgG for floating point
+		 * numbers and s for the default representation. */
+		struct format_spec
+		{
+			FMTG_CONSTEXPR format_spec() :
+				fill_(' '), align_('\0'), sign_('-'), alternate_(false),
+				width_(0), precision_(-1), type_('\0'), zero_(false)
+			{
+			}
+			FMTG_CONSTEXPR format_spec(char fill, char align, char sign, bool alternate,
+			                           std::size_t width, int precision, char type, bool zero) :
+				fill_(fill), align_(align), sign_(sign), alternate_(alternate),
+				width_(width), precision_(precision), type_(type), zero_(zero)
+			{
+			}
+			/** The character to pad with. */
+			char fill_;
+			/** The alignment or '\0' for the default one of the type. */
+			char align_;
+			char sign_;
+			/** True if the prefix of the base is written. */
+			bool alternate_;
+			std::size_t width_;
+			/** The precision or -1 if there is none. */
+			int precision_;
+			/** The presentation type or '\0' for the default one. */
+			char type_;
+			/** True if the fill is set by the 0 flag, the fill and
+			 * the '=' alignment it implies apply to numbers only. */
+			bool zero_;
+		};
+
+		/** Replacement field of the formatting string: {} refers
+		 * to the next argument, {0} to the argument by its index
+		 * and {name} to the argument named by @ref formatting::arg.
+		 * Any of them can have a format spec as in {:>8} or {0:.2f}. */
+		struct field
+		{
+			enum kind
+			{
+				automatic,
+				positional,
+				named
+			};
+			field() :
+				kind_(automatic), index_(0), name_(NULL), name_length_(0),
+				spec_(), has_spec_(false), invalid_spec_(false)
+			{
+			}
+			kind kind_;
+			std::size_t index_;
+			const char* name_;
+			std::size_t name_length_;
+			format_spec spec_;
+			bool has_spec_;
+			/** The spec can't be parsed, the field is reported
+			 * instead of being written. */
+			bool invalid_spec_;
+		};
+
+		/** Returns true if the field is {} while earlier fields refer
+		 * to arguments by index or the other way around, as the fields
+		 * of one formatting string use one kind of indexing. The kind
+		 * of the first indexed field is kept in indexing, which is
+		 * field::named until there is one. */
+		FMTG_INLINE bool mixesIndexing(field::kind kind, field::kind& indexing)
+		{
+			if (kind == field::named)
+				return false;
+			if (indexing == field::named)
+				indexing = kind;
+			return kind != indexing;
+		}
+
+		FMTG_INLINE bool isDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+		FMTG_INLINE bool isIdentifierStart(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+		}
+
+		FMTG_CONSTEXPR bool isAlign(char c)
+		{
+			return c == '<' || c == '>' || c == '^' || c == '=';
+		}
+		FMTG_CONSTEXPR bool isSign(char c)
+		{
+			return c == '+' || c == '-' || c == ' ';
+		}
+		FMTG_CONSTEXPR bool isPresentation(char c)
+		{
+			return c == 'd' || c == 'x' || c == 'X' || c == 'o' || c == 'b' ||
+			       c == 'e' || c == 'E' || c == 'f' || c == 'F' || c == 'g' || c == 'G' || c == 's';
+		}
+		/** Maximal width and precision, larger ones are clamped. */
+		static const std::size_t max_spec_number = 100000;
+		/** Maximal index of a field, larger ones are clamped, so that
+		 * they are out of range instead of wrapping around. */
+		static const std::size_t max_field_index = 100000;
+
+		/** Parses the format spec that starts after the colon.
+		 *
+		 * @return the pointer past the spec or NULL if it is invalid
+		 */
+		FMTG_INLINE const char* parseSpec(const char* p, const char* end, format_spec& spec)
+		{
+			bool explicit_fill = false;
+			if (end - p >= 2 && isAlign(p[1]) && p[0] != '{' && p[0] != '}')
+			{
+				spec.fill_ = p[0];
+				spec.align_ = p[1];
+				explicit_fill = true;
+				p += 2;
+			}
+			else if (p != end && isAlign(*p))
+				spec.align_ = *p++;
+			if (p != end && isSign(*p))
+				spec.sign_ = *p++;
+			if (p != end && *p == '#')
+			{
+				spec.alternate_ = true;
+				p++;
+			}
+			if (p != end && *p == '0')
+			{
+				if (!explicit_fill)
+				{
+					spec.fill_ = '0';
+					spec.zero_ = true;
+				}
+				if (!spec.align_)
+					spec.align_ = '=';
+				p++;
+			}
+			for (; p != end && isDigit(*p); ++p)
+				spec.width_ = std::min(spec.width_*10 + (*p - '0'), max_spec_number);
+			if (p != end && *p == '.')
+			{
+				if (++p == end || !isDigit(*p))
+					return NULL;
+				std::size_t precision = 0;
+				for (; p != end && isDigit(*p); ++p)
+					precision = std::min(precision*10 + (*p - '0'), max_spec_number);
+				spec.precision_ = static_cast<int>(precision);
+			}
+			if (p != end && isPresentation(*p))
+				spec.type_ = *p++;
+			return p;
+		}
+
+		/** Finds the end of a field whose spec can't be parsed, the
+		 * spec runs to the closing brace and can't contain an opening
+		 * one, otherwise the braces are literal text.
+		 *
+		 * @return the pointer past the closing brace or NULL
+		 */
+		FMTG_INLINE const char* invalidSpecEnd(const char* p, const char* end, field& parsed)
+		{
+			for (; p != end; ++p)
+			{
+				if (*p == '{')
+					return NULL;
+				if (*p == '}')
+				{
+					parsed.invalid_spec_ = true;
+					return p + 1;
+				}
+			}
+			return NULL;
+		}
+
+		/** Parses the replacement field that starts with the brace
+		 * pointed by begin. Braces that don't start a valid field
+		 * are left to be literal text, a field with a spec that
+		 * can't be parsed is marked by invalid_spec_.
+		 *
+		 * @return the pointer past the closing brace or NULL if
+		 *         there is no valid field
+		 */
+		FMTG_INLINE const char* parseField(const char* begin, const char* end, field& parsed)
+		{
+			const char* p = begin + 1;
+			if (p == end)
+				return NULL;
+			parsed = field();
+			if (isDigit(*p))
+			{
+				parsed.kind_ = field::positional;
+				for (; p != end && isDigit(*p); ++p)
+					parsed.index_ = std::min(parsed.index_*10 + (*p - '0'), max_field_index);
+			}
+			else if (isIdentifierStart(*p))
+			{
+				parsed.kind_ = field::named;
+				parsed.name_ = p;
+				for (; p != end && (isIdentifierStart(*p) || isDigit(*p)); ++p)
+					;
+				parsed.name_length_ = p - parsed.name_;
+			}
+			if (p != end && *p == ':')
+			{
+				const char* spec_end = parseSpec(p + 1, end, parsed.spec_);
+				if (spec_end == NULL || spec_end == end || *spec_end != '}')
+					return invalidSpecEnd(p + 1, end, parsed);
+				p = spec_end;
+				parsed.has_spec_ = true;
+			}
+			if (p == end || *p != '}')
+				return NULL;
+			return p + 1;
+		}
+
+		/** Checks 8 characters at a step with word operations. */
+		FMTG_INLINE const char* findBraceScalar(const char* p, const char* end)
+		{
+			const unsigned long long ones = 0x0101010101010101ull;
+			const unsigned long long highs = 0x8080808080808080ull;
+			for (; end - p >= 8; p += 8)
+			{
+				unsigned long long word;
+				std::memcpy(&word, p, 8);
+				const unsigned long long open = word ^ (ones * '{');
+				const unsigned long long close = word ^ (ones * '}');
+				// nonzero if any byte of open or close is zero
+				if ((((open - ones) & ~open) | ((close - ones) & ~close)) & highs)
+					break;
+			}
+			for (; p != end; ++p)
+			{
+				if (*p == '{' || *p == '}')
+					return p;
+			}
+			return end;
+		}
+
+#if defined(FMTG_SIMD_AVX2) || defined(FMTG_SIMD_SSE2)
+		FMTG_INLINE unsigned firstSetBit(unsigned mask)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return index;
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+		/** Returns the bytes of 16 characters that are braces. */
+		FMTG_INLINE __m128i braces16(const char* p)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			return _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), 
+			                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')));
+		}
+		/** Checks 64 characters at a step while there are no
+		 * braces and then 16 at a step. */
+		FMTG_INLINE const char* findBraceSse2(const char* p, const char* end)
+		{
+			for (; end - p >= 64; p += 64)
+			{
+				const __m128i any = _mm_or_si128(_mm_or_si128(braces16(p), braces16(p + 16)),
+				                                 _mm_or_si128(braces16(p + 32), braces16(p + 48)));
+				if (_mm_movemask_epi8(any) != 0)
+					break;
+			}
+			for (; end - p >= 16; p += 16)
+			{
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(braces16(p)));
+				if (mask != 0)
+					return p + firstSetBit(mask);
+			}
+			return findBraceScalar(p, end);
+		}
+#endif
+
+#if defined(FMTG_SIMD_AVX2) || defined(FMTG_SIMD_AVX2_DISPATCH)
+#ifdef FMTG_SIMD_AVX2_DISPATCH
+		__attribute__((target("avx2")))
+#endif
+		/** Returns the bytes of 32 characters that are braces. */
+		inline __m256i braces32(const char* p, __m256i open, __m256i close)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			return _mm256_or_si256(_mm256_cmpeq_epi8(chunk, open), _mm256_cmpeq_epi8(chunk, close));
+		}
+#ifdef FMTG_SIMD_AVX2_DISPATCH
+		__attribute__((target("avx2")))
+#endif
+		/** Checks 128 characters at a step while there are no
+		 * braces and then 32 at a step. */
+		inline const char* findBraceAvx2(const char* p, const char* end)
+		{
+			const __m256i open = _mm256_set1_epi8('{');
+			const __m256i close = _mm256_set1_epi8('}');
+			if (end - p >= 160)
+			{
+				// the first characters are checked unaligned and
+				// the loop goes on from the next aligned ones
+				const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(braces32(p, open, close)));
+				if (mask != 0)
+					return p + firstSetBit(mask);
+				p += 32 - (reinterpret_cast<std::size_t>(p) & 31);
+			}
+			for (; end - p >= 128; p += 128)
+			{
+				const __m256i any = _mm256_or_si256(
+					_mm256_or_si256(braces32(p, open, close), braces32(p + 32, open, close)),
+					_mm256_or_si256(braces32(p + 64, open, close), braces32(p + 96, open, close)));
+				if (!_mm256_testz_si256(any, any))
+					break;
+			}
+			for (; end - p >= 32; p += 32)
+			{
+				const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(braces32(p, open, close)));
+				if (mask != 0)
+					return p + firstSetBit(mask);
+			}
+			return findBraceSse2(p, end);
+		}
+#endif
+
+#ifdef FMTG_SIMD_AVX2_DISPATCH
+		FMTG_INLINE bool detectAvx2()
+		{
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") != 0;
+		}
+		FMTG_INLINE bool hasAvx2()
+		{
+			static const bool avx2 = detectAvx2();
+			return avx2;
+		}
+#endif
+
+		/** Returns the first { or } in the text or end if there 
+		 * is none. The text is checked 32 characters at a step
+		 * with AVX2, when it is enabled or, with runtime dispatch,
+		 * detected for texts of 64 characters or longer, 16 at
+		 * a step with SSE2 and 8 at a step otherwise. */
+		FMTG_INLINE const char* findBrace(const char* p, const char* end)
+		{
+#if defined(FMTG_SIMD_AVX2)
+			return findBraceAvx2(p, end);
+#elif defined(FMTG_SIMD_AVX2_DISPATCH)
+			return end - p >= 64 && hasAvx2() ? findBraceAvx2(p, end) : findBraceSse2(p, end);
+#elif defined(FMTG_SIMD_SSE2)
+			return findBraceSse2(p, end);
+#else
+			return findBraceScalar(p, end);
+#endif
+		}
+
+		/** Appends the literal text collapsing both {{ and }}. */
+		FMTG_INLINE void appendUnescaped(buffer& formatted, const char* begin, const char* end)
+		{
+			for (const char* p = findBrace(begin, end); p != end; p = findBrace(p + 1, end))
+			{
+				if (p + 1 != end && p[1] == *p)
+				{
+					formatted.append(begin, p + 1);
+					begin = ++p + 1;
+				}
+			}
+			formatted.append(begin, end);
+		}
+
+		/** Returns true if the argument name is the same as
+		 * the name of the field. */
+		FMTG_INLINE bool sameName(const char* field_name, std::size_t length, const char* name)
+		{
+			return name != NULL && std::strncmp(field_name, name, length) == 0 && name[length] == '\0';
+		}
+
+		/** Where the representation of an argument was written,
+		 * to copy it instead of converting the argument again. */
+		struct rendered
+		{
+			rendered() :
+				position_(static_cast<std::size_t>(-1)), length_(0)
+			{
+			}
+			std::size_t position_;
+			std::size_t length_;
+		};
+	}
+}
+#endif
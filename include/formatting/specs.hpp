@@ -0,0 +1,393 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FORMATTING_SPECS_H_
+#define FORMATTING_SPECS_H_
+
+namespace formatting
+{
+	namespace internal
+	{
+		namespace
+		{
+			/** Numbers of fill characters around and inside the
+			 * representation: the inside ones follow the sign and
+			 * the prefix of a number aligned by '='. */
+			struct padding
+			{
+				padding(const format_spec& spec, std::size_t length, char default_align) :
+					before_(0), inside_(0), after_(0)
+				{
+					const std::size_t n = spec.width_ > length ? spec.width_ - length : 0;
+					switch (spec.align_ ? spec.align_ : default_align)
+					{
+						case '<':
+							after_ = n;
+							break;
+						case '^':
+							before_ = n / 2;
+							after_ = n - before_;
+							break;
+						case '=':
+							inside_ = n;
+							break;
+						default:
+							before_ = n;
+					}
+				}
+				std::size_t before_;
+				std::size_t inside_;
+				std::size_t after_;
+			};
+
+			FMTG_INLINE void writeFill(buffer& formatted, char fill, std::size_t n)
+			{
+				char characters[16];
+				std::memset(characters, fill, sizeof(characters));
+				for (; n > sizeof(characters); n -= sizeof(characters))
+					formatted.append(characters, characters + sizeof(characters));
+				formatted.append(characters, characters + n);
+			}
+
+			/** Writes the characters padded to the width of the spec,
+			 * the first prefix_length characters are the sign and 
+			 * the prefix of a number. */
+			FMTG_INLINE void writeAligned(buffer& formatted, const format_spec& spec, const char* begin, 
+			                              const char* end, std::size_t prefix_length, char default_align)
+			{
+				const padding fill(spec, end - begin, default_align);
+				writeFill(formatted, spec.fill_, fill.before_);
+				formatted.append(begin, begin + prefix_length);
+				writeFill(formatted, spec.fill_, fill.inside_);
+				formatted.append(begin + prefix_length, end);
+				writeFill(formatted, spec.fill_, fill.after_);
+			}
+
+			/** Returns the spec with the fill and the alignment of
+			 * the 0 flag dropped, for values that are not padded
+			 * with zeros. */
+			FMTG_INLINE format_spec withoutZeroFlag(const format_spec& spec)
+			{
+				format_spec plain = spec;
+				if (plain.zero_)
+				{
+					plain.fill_ = ' ';
+					if (plain.align_ == '=')
+						plain.align_ = '\0';
+					plain.zero_ = false;
+				}
+				return plain;
+			}
+
+			FMTG_CONSTEXPR bool isFloatingPresentation(char type)
+			{
+				return type == 'e' || type == 'E' || type == 'f' || type == 'F' || type == 'g' || type == 'G';
+			}
+			FMTG_CONSTEXPR bool isIntegerPresentation(char type)
+			{
+				return type == 'd' || type == 'x' || type == 'X' || type == 'o' || type == 'b';
+			}
+
+			FMTG_INLINE void writeFloatingWithSpec(buffer& formatted, double value, const format_spec& spec)
+			{
+				basic_memory_buffer<64> rendered;
+				const decomposed_float decomposed = decompose(value);
+				// NaNs are written with no minus, so they take the sign of the spec
+				if ((!decomposed.negative || decomposed.kind == decomposed_float::not_a_number) && spec.sign_ != '-')
+					rendered.push_back(spec.sign_);
+				const unsigned int precision = spec.precision_ < 0 ? 6 : static_cast<unsigned int>(spec.precision_);
+				switch (spec.type_)
+				{
+					case 'e':
+					case 'E':
+						writeScientific(rendered, value, precision);
+						break;
+					case 'f':
+					case 'F':
+						writeFixed(rendered, value, precision);
+						break;
+					case 'g':
+					case 'G':
+						writePrecision(rendered, value, precision);
+						break;
+					default:
+						if (spec.precision_ < 0)
+							writeShortest(rendered, value);
+						else
+							writePrecision(rendered, value, precision);
+				}
+				if (spec.type_ == 'E' || spec.type_ == 'F' || spec.type_ == 'G')
+				{
+					for (char* c = rendered.data(); c != rendered.data() + rendered.size(); ++c)
+						*c = (*c >= 'a' && *c <= 'z') ? static_cast<char>(*c - 'a' + 'A') : *c;
+				}
+				const std::size_t sign = rendered.size() > 0 && isSign(rendered.data()[0]) ? 1 : 0;
+				// zeros are not padding of infinities and NaNs, like in printf
+				if (decomposed.kind == decomposed_float::infinite || decomposed.kind == decomposed_float::not_a_number)
+					writeAligned(formatted, withoutZeroFlag(spec), rendered.begin(), rendered.end(), sign, '>');
+				else
+					writeAligned(formatted, spec, rendered.begin(), rendered.end(), sign, '>');
+			}
+
+			template <typename T>
+			FMTG_INLINE void writeIntegerWithSpec(buffer& formatted, T value, const format_spec& spec)
+			{
+				if (isFloatingPresentation(spec.type_))
+				{
+					writeFloatingWithSpec(formatted, static_cast<double>(value), spec);
+					return;
+				}
+				typedef typename unsigned_of<T>::type U;
+				char characters[sizeof(U) * 8 + 4];
+				char* end = characters + sizeof(characters);
+				char* begin;
+				const U magnitude = absoluteValue(value);
+				char base = '\0';
+				switch (spec.type_)
+				{
+					case 'x':
+						begin = formatPowerOf2<4>(end, magnitude, true);
+						base = 'x';
+						break;
+					case 'X':
+						begin = formatPowerOf2<4>(end, magnitude);
+						base = 'X';
+						break;
+					case 'o':
+						begin = formatPowerOf2<3>(end, magnitude);
+						base = 'o';
+						break;
+					case 'b':
+						begin = formatPowerOf2<1>(end, magnitude);
+						base = 'b';
+						break;
+					default:
+						begin = formatDecimal(end, magnitude);
+				}
+				if (spec.alternate_ && base)
+				{
+					*--begin = base;
+					*--begin = '0';
+				}
+				if (isNegative(value))
+					*--begin = '-';
+				else if (spec.sign_ != '-')
+					*--begin = spec.sign_;
+				writeAligned(formatted, spec, begin, end, (spec.alternate_ && base ? 2 : 0) + (isSign(*begin) ? 1 : 0), '>');
+			}
+
+			FMTG_INLINE void writeStringWithSpec(buffer& formatted, const char* data, std::size_t length,
+			                                     const format_spec& spec)
+			{
+				if (spec.precision_ >= 0)
+					length = utf8Prefix(data, length, static_cast<std::size_t>(spec.precision_));
+				writeAligned(formatted, withoutZeroFlag(spec), data, data + length, 0, '<');
+			}
+
+			enum spec_category
+			{
+				other_spec,
+				integer_spec,
+				floating_spec,
+				string_spec
+			};
+			/** Tells how a spec applies to the values of type T, 
+			 * types that have @ref formatting::formatter specialized
+			 * are only padded. */
+			template <typename T>
+			struct specCategory
+			{
+				enum { value = has_formatter<T>::value || is_char<T>::value || is_same<T, bool>::value ? other_spec :
+				               std::numeric_limits<T>::is_integer ? integer_spec :
+				               is_same<T, float>::value || is_same<T, double>::value || 
+				               is_same<T, long double>::value ? floating_spec :
+				               is_same<T, std::string>::value || is_same<T, const char*>::value || 
+				               is_same<T, char*>::value ? string_spec : other_spec };
+			};
+			/** Named arguments are formatted as their values. */
+			template <typename T>
+			struct specCategory< wrappers::NamedWrapper<T> >
+			{
+				enum { value = specCategory<T>::value };
+			};
+#ifdef FMTG_USE_CXX17
+			template <>
+			struct specCategory<std::string_view>
+			{
+				enum { value = string_spec };
+			};
+#endif
+
+			/** Returns true if the presentation type applies to values
+			 * of the category: integer ones don't apply to floating-point
+			 * values and strings, numeric ones don't apply to strings. */
+			FMTG_CONSTEXPR bool presentationApplies(char type, int category)
+			{
+				return category == floating_spec ? !isIntegerPresentation(type) :
+				       category == string_spec ? !isIntegerPresentation(type) && !isFloatingPresentation(type) : true;
+			}
+
+			/** Writes the representation fields with no spec write
+			 * and keeps where it is in output. */
+			template <typename T>
+			FMTG_INLINE void writeKept(buffer& formatted, const T& value, rendered& output)
+			{
+				output.position_ = formatted.written();
+				writeArgument(formatted, value);
+				output.length_ = formatted.written() - output.position_;
+			}
+
+			/** Writes any representation padded to the width. The
+			 * 0 flag doesn't apply, like for strings. The representation
+			 * of the argument is copied if another field has written it
+			 * and it is still in the buffer, otherwise it is written once
+			 * into the stack buffer to be measured. */
+			template <typename T, int category>
+			struct specImplementation
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const T& value, const format_spec& spec, 
+				                            rendered& output) const
+				{
+					const format_spec plain = withoutZeroFlag(spec);
+					if (output.position_ != static_cast<std::size_t>(-1))
+					{
+						const padding fill(plain, output.length_, '<');
+						writeFill(formatted, plain.fill_, fill.before_ + fill.inside_);
+						if (!formatted.repeat(output.position_, output.length_))
+							writeKept(formatted, value, output);
+						writeFill(formatted, plain.fill_, fill.after_);
+						return;
+					}
+					if (spec.width_ == 0)
+					{
+						writeKept(formatted, value, output);
+						return;
+					}
+					basic_memory_buffer<64> representation;
+					writeArgument(representation, value);
+					const padding fill(plain, representation.size(), '<');
+					writeFill(formatted, plain.fill_, fill.before_ + fill.inside_);
+					output.position_ = formatted.written();
+					formatted.append(representation.begin(), representation.end());
+					output.length_ = representation.size();
+					writeFill(formatted, plain.fill_, fill.after_);
+				}
+			};
+			/** Specs of numbers and strings change the representation,
+			 * it is written from the value every time. */
+			template <typename T>
+			struct specImplementation<T, integer_spec>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const T& value, const format_spec& spec, 
+				                            rendered&) const
+				{
+					writeIntegerWithSpec(formatted, value, spec);
+				}
+			};
+			template <typename T>
+			struct specImplementation<T, floating_spec>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const T& value, const format_spec& spec, 
+				                            rendered&) const
+				{
+					writeFloatingWithSpec(formatted, static_cast<double>(value), spec);
+				}
+			};
+			template <typename T>
+			struct specImplementation<T, string_spec>
+			{
+				FMTG_INLINE void operator()(buffer& formatted, const T& value, const format_spec& spec, 
+				                            rendered&) const
+				{
+					const char* data;
+					std::size_t length;
+					getCharacters(value, data, length);
+					writeStringWithSpec(formatted, data, length, spec);
+				}
+			};
+		}
+
+		/** Returns true if the presentation type of the spec applies
+		 * to values of type T, see @ref presentationApplies. */
+		template <typename T>
+		FMTG_INLINE bool specApplies(const format_spec& spec)
+		{
+			typedef typename decayed<T>::type value_type;
+			return presentationApplies(spec.type_, specCategory<value_type>::value);
+		}
+
+		/** Appends the representation of the value formatted by
+		 * the spec. Presentation types that don't apply to the
+		 * value are not written, e.g. {:x} of a string. The output
+		 * of the argument is shared with fields that have no spec,
+		 * see @ref specImplementation.
+		 *
+		 * @return false if the presentation type doesn't apply
+		 */
+		template <typename T>
+		FMTG_INLINE bool writeWithSpec(buffer& formatted, const T& value, const format_spec& spec, rendered& output)
+		{
+			typedef typename decayed<T>::type value_type;
+			if (!presentationApplies(spec.type_, specCategory<value_type>::value))
+				return false;
+			specImplementation<value_type, specCategory<value_type>::value>()(formatted, value, spec, output);
+			return true;
+		}
+		/** Named arguments are formatted as their values. */
+		template <typename T>
+		FMTG_INLINE bool writeWithSpec(buffer& formatted, const wrappers::NamedWrapper<T>& value, const format_spec& spec,
+		                               rendered& output)
+		{
+			return writeWithSpec(formatted, value.value_, spec, output);
+		}
+		/** Formats the value that no other field refers to. */
+		template <typename T>
+		FMTG_INLINE bool writeWithSpec(buffer& formatted, const T& value, const format_spec& spec)
+		{
+			rendered output;
+			return writeWithSpec(formatted, value, spec, output);
+		}
+
+		/** Writer with the spec that is used by @ref ValueWrapper. */
+		template <typename T>
+		bool writeValueWithSpec(buffer& formatted, const void* value, const format_spec& spec, rendered& output)
+		{
+			return writeWithSpec(formatted, *static_cast<const T*>(value), spec, output);
+		}
+
+		/** Writer with the spec of the default constructed @ref ValueWrapper. */
+		inline bool writeInvalidArgumentWithSpec(buffer& formatted, const void* value, const format_spec&, rendered&)
+		{
+			writeInvalidArgument(formatted, value);
+			return true;
+		}
+	}
+}
+#endif
@@ -0,0 +1,492 @@
+/** A simple formatter that uses simple "{}" placeholder.
+ * Resembles SLF4J and Python format.
+ *
+ * Copyright (c) 2013, Sergey Lisitsyn <lisitsyn.s.o@gmail.com>
+ * All rights reserved.
+ *
+ * Distributed under the BSD 2-clause license:
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, 
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice, 
+ *   this list of conditions and the following disclaimer in the documentation 
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES 
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, 
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FORMATTING_STATIC_FORMAT_H_
+#define FORMATTING_STATIC_FORMAT_H_
+
+#ifdef FMTG_USE_CXX11
+
+#include <tuple>
+#include <type_traits>
+
+/** Makes a formatter of the string literal that is parsed at
+ * compile time. The number of provided arguments is checked at
+ * compile time as well and the formatter writes literal segments
+ * and arguments straight to the result with no scanning.
+ *
+ * E.g. FMTG_FORMAT("{} + {} is {}")(2, 2, 4) => '2 + 2 is 4'
+ *
+ * @param fmt the formatting string literal
+ */
+#define FMTG_FORMAT(fmt) \
+	([] { \
+		struct fmtg_literal \
+		{ \
+			static constexpr const char* data() { return "" fmt; } \
+			static constexpr std::size_t size() { return sizeof("" fmt) - 1; } \
+		}; \
+		return formatting::internal::StaticFormat<fmtg_literal>(); \
+	}())
+
+namespace formatting
+{
+	namespace internal
+	{
+		constexpr bool isDigitAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && s[position] >= '0' && s[position] <= '9';
+		}
+		constexpr bool isIdentifierAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && ((s[position] >= 'a' && s[position] <= 'z') || 
+			       (s[position] >= 'A' && s[position] <= 'Z') || s[position] == '_');
+		}
+		/** Returns the position past the digits starting at position. */
+		constexpr std::size_t digitsEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return isDigitAt(s, position, size) ? digitsEnd(s, position + 1, size) : position;
+		}
+		/** Returns the position past the identifier starting at position. */
+		constexpr std::size_t identifierEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return isIdentifierAt(s, position, size) || isDigitAt(s, position, size) ?
+			       identifierEnd(s, position + 1, size) : position;
+		}
+		/** Returns the position past the index or the name of the
+		 * field which content starts at position. */
+		constexpr std::size_t contentEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return isDigitAt(s, position, size) ? digitsEnd(s, position, size) :
+			       isIdentifierAt(s, position, size) ? identifierEnd(s, position, size) : position;
+		}
+		constexpr std::size_t closingBrace(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && s[position] == '}' ? position + 1 : 0;
+		}
+
+		/* Stages of the format spec like in @ref parseSpec, each
+		 * returns the position past its part given the position
+		 * where the part may start. */
+		constexpr bool hasFillAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return position + 1 < size && isAlign(s[position + 1]) && s[position] != '{' && s[position] != '}';
+		}
+		constexpr bool hasAlignAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return hasFillAt(s, position, size) || (position < size && isAlign(s[position]));
+		}
+		constexpr std::size_t alignEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return hasFillAt(s, position, size) ? position + 2 : hasAlignAt(s, position, size) ? position + 1 : position;
+		}
+		constexpr std::size_t signEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && isSign(s[position]) ? position + 1 : position;
+		}
+		constexpr std::size_t characterEnd(const char* s, std::size_t position, std::size_t size, char c)
+		{
+			return position < size && s[position] == c ? position + 1 : position;
+		}
+		/** Returns the position past the precision or size if
+		 * the point has no digits, so that there is no field. */
+		constexpr std::size_t precisionEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return !(position < size && s[position] == '.') ? position :
+			       isDigitAt(s, position + 1, size) ? digitsEnd(s, position + 1, size) : size;
+		}
+		constexpr std::size_t typeEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && isPresentation(s[position]) ? position + 1 : position;
+		}
+		/** Returns the position past [fill]align[sign][#]. */
+		constexpr std::size_t alternateEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return characterEnd(s, signEnd(s, alignEnd(s, position, size), size), size, '#');
+		}
+		/** Returns the position past [fill]align[sign][#][0]. */
+		constexpr std::size_t zeroEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return characterEnd(s, alternateEnd(s, position, size), size, '0');
+		}
+		constexpr std::size_t widthEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return digitsEnd(s, zeroEnd(s, position, size), size);
+		}
+		constexpr std::size_t specEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return typeEnd(s, precisionEnd(s, widthEnd(s, position, size), size), size);
+		}
+		/** Returns the position past the spec if there is a colon at position. */
+		constexpr std::size_t optionalSpecEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && s[position] == ':' ? specEnd(s, position + 1, size) : position;
+		}
+		constexpr std::size_t parseSpecNumber(const char* s, std::size_t begin, std::size_t end, std::size_t value)
+		{
+			return begin == end ? value : parseSpecNumber(s, begin + 1, end, 
+				value*10 + (s[begin] - '0') < max_spec_number ? value*10 + (s[begin] - '0') : max_spec_number);
+		}
+		constexpr bool hasZeroAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return zeroEnd(s, position, size) != alternateEnd(s, position, size);
+		}
+		/** Returns the spec that starts at position like @ref parseSpec does. */
+		constexpr format_spec specAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return format_spec(
+				hasFillAt(s, position, size) ? s[position] : hasZeroAt(s, position, size) ? '0' : ' ',
+				hasFillAt(s, position, size) ? s[position + 1] : hasAlignAt(s, position, size) ? s[position] : 
+				                               hasZeroAt(s, position, size) ? '=' : '\0',
+				signEnd(s, alignEnd(s, position, size), size) != alignEnd(s, position, size) ? 
+					s[alignEnd(s, position, size)] : '-',
+				alternateEnd(s, position, size) != signEnd(s, alignEnd(s, position, size), size),
+				parseSpecNumber(s, zeroEnd(s, position, size), widthEnd(s, position, size), 0),
+				precisionEnd(s, widthEnd(s, position, size), size) == widthEnd(s, position, size) ? -1 :
+					static_cast<int>(parseSpecNumber(s, widthEnd(s, position, size) + 1, 
+					                                 precisionEnd(s, widthEnd(s, position, size), size), 0)),
+				typeEnd(s, precisionEnd(s, widthEnd(s, position, size), size), size) != 
+					precisionEnd(s, widthEnd(s, position, size), size) ? 
+					s[precisionEnd(s, widthEnd(s, position, size), size)] : '\0',
+				hasZeroAt(s, position, size) && !hasFillAt(s, position, size));
+		}
+
+		/** Returns the number of opening braces right before position. */
+		constexpr std::size_t bracesBefore(const char* s, std::size_t position)
+		{
+			return position > 0 && s[position - 1] == '{' ? 1 + bracesBefore(s, position - 1) : 0;
+		}
+		/** Returns true if the brace at position is a part of {{,
+		 * braces are paired from the first one of a run. */
+		constexpr bool isEscapedAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return bracesBefore(s, position) % 2 == 1 || (position + 1 < size && s[position + 1] == '{');
+		}
+		/** Returns the position past the field that starts at 
+		 * position or 0 if there is no field, like @ref parseField. */
+		constexpr std::size_t fieldEnd(const char* s, std::size_t position, std::size_t size)
+		{
+			return s[position] != '{' || isEscapedAt(s, position, size) ? 0 : 
+			       closingBrace(s, optionalSpecEnd(s, contentEnd(s, position + 1, size), size), size);
+		}
+		constexpr bool isFieldAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return fieldEnd(s, position, size) != 0;
+		}
+		/** Returns true if there is a closing brace from position
+		 * on before any opening one. */
+		constexpr bool isClosedAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return position < size && s[position] != '{' && 
+			       (s[position] == '}' || isClosedAt(s, position + 1, size));
+		}
+		/** Returns true if a field with a spec that can't be parsed
+		 * starts at position, like @ref invalidSpecEnd finds it. */
+		constexpr bool isInvalidSpecAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return s[position] == '{' && !isEscapedAt(s, position, size) && !isFieldAt(s, position, size) &&
+			       contentEnd(s, position + 1, size) < size && s[contentEnd(s, position + 1, size)] == ':' &&
+			       isClosedAt(s, contentEnd(s, position + 1, size) + 1, size);
+		}
+		constexpr bool isAutomaticAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return isFieldAt(s, position, size) && contentEnd(s, position + 1, size) == position + 1;
+		}
+		constexpr bool hasSpecAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return optionalSpecEnd(s, contentEnd(s, position + 1, size), size) != contentEnd(s, position + 1, size);
+		}
+		constexpr bool isNamedAt(const char* s, std::size_t position, std::size_t size)
+		{
+			return isFieldAt(s, position, size) && isIdentifierAt(s, position + 1, size);
+		}
+		constexpr std::size_t parseIndex(const char* s, std::size_t begin, std::size_t end, std::size_t index)
+		{
+			return begin == end ? index : parseIndex(s, begin + 1, end, 
+				index*10 + (s[begin] - '0') < max_field_index ? index*10 + (s[begin] - '0') : max_field_index);
+		}
+
+		/** Counts fields starting in [begin, end). Bisects
+		 * the range to keep the recursion depth logarithmic. */
+		constexpr std::size_t countFields(const char* s, std::size_t size, std::size_t begin, std::size_t end)
+		{
+			return end - begin == 0 ? 0 :
+			       end - begin == 1 ? (isFieldAt(s, begin, size) ? 1 : 0) :
+			       countFields(s, size, begin, begin + (end-begin)/2) +
+			       countFields(s, size, begin + (end-begin)/2, end);
+		}
+		/** Counts {name} fields starting in [begin, end). */
+		constexpr std::size_t countNamed(const char* s, std::size_t size, std::size_t begin, std::size_t end)
+		{
+			return end - begin == 0 ? 0 :
+			       end - begin == 1 ? (isNamedAt(s, begin, size) ? 1 : 0) :
+			       countNamed(s, size, begin, begin + (end-begin)/2) +
+			       countNamed(s, size, begin + (end-begin)/2, end);
+		}
+
+		/** Counts fields with invalid specs starting in [begin, end). */
+		constexpr std::size_t countInvalidSpecs(const char* s, std::size_t size, std::size_t begin, std::size_t end)
+		{
+			return end - begin == 0 ? 0 :
+			       end - begin == 1 ? (isInvalidSpecAt(s, begin, size) ? 1 : 0) :
+			       countInvalidSpecs(s, size, begin, begin + (end-begin)/2) +
+			       countInvalidSpecs(s, size, begin + (end-begin)/2, end);
+		}
+
+		/** Returns true if there is {{ or }} in [begin, end). */
+		constexpr bool hasEscapes(const char* s, std::size_t begin, std::size_t end)
+		{
+			return end - begin < 2 ? false :
+			       end - begin == 2 ? (s[begin] == '{' || s[begin] == '}') && s[begin + 1] == s[begin] :
+			       hasEscapes(s, begin, begin + (end-begin)/2 + 1) || hasEscapes(s, begin + (end-begin)/2, end);
+		}
+
+		/** Returns the position of the first field in [begin, end)
+		 * or end if there is none. Bisects the range like @ref
+		 * countFields and stops at the first half that has a field. */
+		constexpr std::size_t firstField(const char* s, std::size_t size, std::size_t begin, std::size_t end);
+		constexpr std::size_t firstFieldOr(const char* s, std::size_t size, std::size_t found, 
+		                                   std::size_t middle, std::size_t end)
+		{
+			return found != middle ? found : firstField(s, size, middle, end);
+		}
+		constexpr std::size_t firstField(const char* s, std::size_t size, std::size_t begin, std::size_t end)
+		{
+			return end - begin == 0 ? end :
+			       end - begin == 1 ? (isFieldAt(s, begin, size) ? begin : end) :
+			       firstFieldOr(s, size, firstField(s, size, begin, begin + (end-begin)/2), 
+			                    begin + (end-begin)/2, end);
+		}
+		constexpr std::size_t maxOf(std::size_t a, std::size_t b)
+		{
+			return a > b ? a : b;
+		}
+
+		/** Stands for the fields before the first one. */
+		struct no_static_field
+		{
+			static constexpr std::size_t end_ = 0;
+			static constexpr std::size_t n_automatic_ = 0;
+			static constexpr std::size_t n_arguments_ = 0;
+		};
+		/** Position, argument index and spec presence of the k-th
+		 * field of Literal. Each field continues from the previous
+		 * one, so that the string is parsed once for all fields. */
+		template <typename Literal, std::size_t K>
+		struct static_field;
+		/** The fields before the k-th one, their last field or
+		 * @ref no_static_field for the first field. */
+		template <typename Literal, std::size_t K>
+		using fields_before = typename std::conditional<K == 0, no_static_field, 
+			static_field<Literal, K - 1>>::type;
+
+		template <typename Literal, std::size_t K>
+		struct static_field
+		{
+			typedef fields_before<Literal, K> previous;
+
+			static constexpr std::size_t begin_ = 
+				firstField(Literal::data(), Literal::size(), previous::end_, Literal::size());
+			static constexpr std::size_t end_ = fieldEnd(Literal::data(), begin_, Literal::size());
+			static constexpr bool automatic_ = isAutomaticAt(Literal::data(), begin_, Literal::size());
+			static constexpr bool has_spec_ = hasSpecAt(Literal::data(), begin_, Literal::size());
+			/** The number of {} fields up to this one inclusive. */
+			static constexpr std::size_t n_automatic_ = previous::n_automatic_ + (automatic_ ? 1 : 0);
+			static constexpr std::size_t index_ = automatic_ ? previous::n_automatic_ :
+				parseIndex(Literal::data(), begin_ + 1, contentEnd(Literal::data(), begin_ + 1, Literal::size()), 0);
+			/** The number of arguments referred by the fields up to this one. */
+			static constexpr std::size_t n_arguments_ = maxOf(previous::n_arguments_, index_ + 1);
+		};
+
+		/** The @ref specCategory of the argument i, arguments
+		 * that are not provided are checked by their number. */
+		template <std::size_t I, typename... Args>
+		struct argument_category
+		{
+			enum { value = other_spec };
+		};
+		template <typename T, typename... Rest>
+		struct argument_category<0, T, Rest...>
+		{
+			enum { value = specCategory<typename decayed<T>::type>::value };
+		};
+		template <std::size_t I, typename T, typename... Rest>
+		struct argument_category<I, T, Rest...>
+		{
+			enum { value = argument_category<I - 1, Rest...>::value };
+		};
+
+		/** Formatter of the compile-time string provided by
+		 * Literal::data() and Literal::size(). Each literal
+		 * segment and argument is written by its own
+		 * instantiation of @ref StaticFormat::write. Arguments
+		 * referred by many fields are converted once and specs
+		 * of fields are parsed at compile time. */
+		template <typename Literal>
+		class StaticFormat
+		{
+		public:
+			static constexpr std::size_t n_placeholders =
+				countFields(Literal::data(), Literal::size(), 0, Literal::size());
+			static constexpr std::size_t n_arguments = 
+				fields_before<Literal, n_placeholders>::n_arguments_;
+			/** The number of {} fields. */
+			static constexpr std::size_t n_automatic = 
+				fields_before<Literal, n_placeholders>::n_automatic_;
+
+			template <typename... Args>
+			FMTG_INLINE std::string operator()(const Args&... args) const
+			{
+				check<Args...>();
+				std::string formatted;
+				string_buffer buffer(formatted);
+				buffer.reserve(Literal::size() + estimateArguments(args...));
+				rendered outputs[n_arguments + 1];
+				write<0>(buffer, outputs, std::integral_constant<bool, n_placeholders == 0>(), args...);
+				buffer.finish();
+				return formatted;
+			}
+			/** Appends the result to the memory buffer. */
+			template <std::size_t N, typename Allocator, typename... Args>
+			FMTG_INLINE void format_to(basic_memory_buffer<N, Allocator>& out, const Args&... args) const
+			{
+				check<Args...>();
+				out.reserve(Literal::size() + estimateArguments(args...));
+				rendered outputs[n_arguments + 1];
+				write<0>(out, outputs, std::integral_constant<bool, n_placeholders == 0>(), args...);
+			}
+		private:
+			template <typename... Args>
+			static constexpr bool check()
+			{
+				static_assert(countNamed(Literal::data(), Literal::size(), 0, Literal::size()) == 0,
+					"Named fields are not supported by FMTG_FORMAT, use compiled_format instead");
+				static_assert(countInvalidSpecs(Literal::data(), Literal::size(), 0, Literal::size()) == 0,
+					"The format spec of the field is invalid");
+				static_assert(specsApply<0, Args...>(std::integral_constant<bool, n_placeholders == 0>()),
+					"The format spec of the field doesn't apply to the type of its argument");
+				static_assert(n_automatic == 0 || n_automatic == n_placeholders,
+					"Automatic and explicit argument indices are mixed");
+				static_assert(sizeof...(Args) == n_arguments,
+					"The number of placeholders doesn't match the number of provided arguments");
+				return true;
+			}
+			/** Returns the spec of the k-th field. */
+			template <std::size_t K>
+			static constexpr format_spec specOf()
+			{
+				return specAt(Literal::data(), 
+					contentEnd(Literal::data(), static_field<Literal, K>::begin_ + 1, Literal::size()) + 1, Literal::size());
+			}
+			/** Returns true if the presentation types of the specs
+			 * of fields from the k-th one on apply to their arguments,
+			 * like @ref writeWithSpec checks them. */
+			template <std::size_t K, typename... Args>
+			static constexpr bool specsApply(std::true_type)
+			{
+				return true;
+			}
+			template <std::size_t K, typename... Args>
+			static constexpr bool specsApply(std::false_type)
+			{
+				return (!static_field<Literal, K>::has_spec_ ||
+				        presentationApplies(specOf<K>().type_, 
+				                            argument_category<static_field<Literal, K>::index_, Args...>::value)) &&
+				       specsApply<K + 1, Args...>(std::integral_constant<bool, K + 1 == n_placeholders>());
+			}
+			/** Returns true if some field before the k-th one has
+			 * written the representation of the same argument, so
+			 * that it can be copied: fields with no spec and, if
+			 * specs only pad the argument, fields with specs. Fields
+			 * are checked from J on. */
+			template <std::size_t K, bool Padded, std::size_t J>
+			static constexpr bool isUsedBefore(std::true_type)
+			{
+				return false;
+			}
+			template <std::size_t K, bool Padded, std::size_t J>
+			static constexpr bool isUsedBefore(std::false_type)
+			{
+				return (static_field<Literal, J>::index_ == static_field<Literal, K>::index_ && 
+				        (!static_field<Literal, J>::has_spec_ || Padded)) || 
+				       isUsedBefore<K, Padded, J + 1>(std::integral_constant<bool, J + 1 == K>());
+			}
+
+			template <std::size_t K, typename... Args>
+			static FMTG_INLINE void write(buffer& formatted, rendered* outputs, std::false_type, const Args&... args)
+			{
+				typedef static_field<Literal, K> field;
+				constexpr std::size_t begin = fields_before<Literal, K>::end_;
+				constexpr std::size_t end = field::begin_;
+				appendSegment(formatted, begin, end, std::integral_constant<bool, 
+					hasEscapes(Literal::data(), begin, end)>());
+				writeField<K>(formatted, outputs[field::index_], std::get<field::index_>(std::forward_as_tuple(args...)),
+				              std::integral_constant<bool, field::has_spec_>());
+				write<K+1>(formatted, outputs, std::integral_constant<bool, K+1 == n_placeholders>(), args...);
+			}
+			template <std::size_t K, typename T>
+			static FMTG_INLINE void writeField(buffer& formatted, rendered& output, const T& value, std::false_type)
+			{
+				constexpr bool padded = static_cast<int>(specCategory<typename decayed<T>::type>::value) == other_spec;
+				constexpr bool used_before = isUsedBefore<K, padded, 0>(std::integral_constant<bool, K == 0>());
+				if (!used_before || !formatted.repeat(output.position_, output.length_))
+				{
+					output.position_ = formatted.written();
+					writeArgument(formatted, value);
+					output.length_ = formatted.written() - output.position_;
+				}
+			}
+			template <std::size_t K, typename T>
+			static FMTG_INLINE void writeField(buffer& formatted, rendered& output, const T& value, std::true_type)
+			{
+				constexpr format_spec spec = specOf<K>();
+				writeWithSpec(formatted, value, spec, output);
+			}
+			template <std::size_t K, typename... Args>
+			static FMTG_INLINE void write(buffer& formatted, rendered*, std::true_type, const Args&...)
+			{
+				constexpr std::size_t begin = fields_before<Literal, K>::end_;
+				appendSegment(formatted, begin, Literal::size(), std::integral_constant<bool, 
+					hasEscapes(Literal::data(), begin, Literal::size())>());
+			}
+			/** Appends the literal segment, escaped braces are
+			 * collapsed only in segments that have them. */
+			static FMTG_INLINE void appendSegment(buffer& formatted, std::size_t begin, std::size_t end, std::false_type)
+			{
+				formatted.append(Literal::data() + begin, Literal::data() + end);
+			}
+			static FMTG_INLINE void appendSegment(buffer& formatted, std::size_t begin, std::size_t end, std::true_type)
+			{
+				appendUnescaped(formatted, Literal::data() + begin, Literal::data() + end);
+			}
+		};
+	}
+}
+
+#endif
+#endif
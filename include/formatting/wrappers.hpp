@@ -31,7 +31,11 @@
 #define FORMATTING_WRAPPERS_H_
 
 #include <limits>
+#ifdef FMTG_NO_IOSTREAM
+#include <iosfwd>
+#else
 #include <iomanip>
+#endif
 
 namespace formatting
 {
@@ -55,12 +59,14 @@ namespace wrappers
 		friend std::ostream& operator<<(std::ostream& out, const HexWrapper<U>& h);
 	};
 
+#ifndef FMTG_NO_IOSTREAM
 	template <typename T>
 	std::ostream& operator<<(std::ostream& out, const HexWrapper<T>& h)
 	{
 		out << "0x" << std::hex << std::uppercase << h.value_;
 		return out;
 	}
+#endif
 
 	template <typename T>
 	struct OctWrapper
@@ -73,12 +79,14 @@ namespace wrappers
 		friend std::ostream& operator<<(std::ostream& out, const HexWrapper<U>& h);
 	};
 
+#ifndef FMTG_NO_IOSTREAM
 	template <typename T>
 	std::ostream& operator<<(std::ostream& out, const OctWrapper<T>& h)
 	{
 		out << "0" << std::oct << std::uppercase << h.value_;
 		return out;
 	}
+#endif
 
 	template <typename T>
 	struct WidthWrapper
@@ -93,12 +101,14 @@ namespace wrappers
 		friend std::ostream& operator<<(std::ostream& out, const WidthWrapper& h);
 	};
 
+#ifndef FMTG_NO_IOSTREAM
 	template <typename T>
 	std::ostream& operator<<(std::ostream& out, const WidthWrapper<T>& h)
 	{
 		out << std::setw(h.width_) << std::setfill(h.filler_) << h.value_;
 		return out;
 	}
+#endif
 
 	struct WidthWrapperBuilder
 	{
@@ -134,12 +144,14 @@ namespace wrappers
 		friend std::ostream& operator<<(std::ostream& out, const PrecisionWrapper& h);
 	};
 
+#ifndef FMTG_NO_IOSTREAM
 	template <typename T>
 	std::ostream& operator<<(std::ostream& out, const PrecisionWrapper<T>& h)
 	{
 		out << std::setprecision(h.precision_) << h.value_;
 		return out;
 	}
+#endif
 
 	struct PrecisionWrapperBuilder
 	{
@@ -162,6 +174,74 @@ namespace wrappers
 		}
 	};
 
+	/** Refers to the value instead of copying it. */
+	template <typename T>
+	struct NamedWrapper
+	{
+		explicit NamedWrapper(const char* name, const T& value) : value_(value), name_(name) { }
+		const T& value_;
+		const char* name_;
+	};
+
+	/** Refers to the container instead of copying it. */
+	template <typename T>
+	struct LimitWrapper
+	{
+		explicit LimitWrapper(std::size_t limit, const T& value) : value_(value), limit_(limit) { }
+		const T& value_;
+		const std::size_t limit_;
+	};
+
+	struct LimitWrapperBuilder
+	{
+		explicit LimitWrapperBuilder(std::size_t limit) : limit_(limit) { }
+		std::size_t limit_;
+
+		template <typename T>
+		inline LimitWrapper<T> operator()(const T& value)
+		{
+			return LimitWrapper<T>(limit_,value);
+		}
+	};
+
+	struct LimitWrapperBuilderHelper
+	{
+		LimitWrapperBuilderHelper() { }
+		inline wrappers::LimitWrapperBuilder operator[](std::size_t n) const
+		{
+			return wrappers::LimitWrapperBuilder(n);
+		}
+	};
+
+	/** Refers to the string instead of copying it. */
+	template <typename T>
+	struct TruncateWrapper
+	{
+		explicit TruncateWrapper(std::size_t length, const T& value) : value_(value), length_(length) { }
+		const T& value_;
+		const std::size_t length_;
+	};
+
+	struct TruncateWrapperBuilder
+	{
+		explicit TruncateWrapperBuilder(std::size_t length) : length_(length) { }
+		std::size_t length_;
+
+		template <typename T>
+		inline TruncateWrapper<T> operator()(const T& value)
+		{
+			return TruncateWrapper<T>(length_,value);
+		}
+	};
+
+	struct TruncateWrapperBuilderHelper
+	{
+		TruncateWrapperBuilderHelper() { }
+		inline wrappers::TruncateWrapperBuilder operator[](std::size_t n) const
+		{
+			return wrappers::TruncateWrapperBuilder(n);
+		}
+	};
 
 }
 
@@ -191,6 +271,20 @@ inline wrappers::OctWrapper<T> oct(T value)
 	return wrappers::OctWrapper<T>(value);
 }
 
+/** Returns a wrapper that names the provided value, so that
+ * it can be referred by the {name} placeholder.
+ *
+ * E.g. formatting::format("{who} is {age}", arg("who", "x"), arg("age", 42)) => 'x is 42'
+ *
+ * @param name the name of the argument, it is not copied
+ * @param value a value to be named
+ */
+template<typename T>
+inline wrappers::NamedWrapper<T> arg(const char* name, const T& value)
+{
+	return wrappers::NamedWrapper<T>(name, value);
+}
+
 /** Returns a wrapper that makes the provided
  * pointer represented as hex value of a pointer.
  *
@@ -224,5 +318,19 @@ static const wrappers::WidthWrapperBuilderHelper width;
  */
 static const wrappers::PrecisionWrapperBuilderHelper precision;
 
+/** Limit wrapper helper that makes containers represented
+ * by at most n first elements followed by the number of
+ * omitted ones. The rest of elements is not visited.
+ * (e.g. limit[2](std::vector<int>(5)) => "[0, 0, … (3 more)]")
+ */
+static const wrappers::LimitWrapperBuilderHelper limit;
+
+/** Truncate wrapper helper that makes strings represented
+ * by at most n first bytes followed by the number of omitted
+ * ones. Multibyte UTF-8 characters are not split.
+ * (e.g. truncate[3]("mister") => "mis… (3 more)")
+ */
+static const wrappers::TruncateWrapperBuilderHelper truncate;
+
 }
 #endif
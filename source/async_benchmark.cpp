@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <formatting/async.hpp>
+
+/** Compares producer latency and throughput of the async sink with
+ * formatting and writing in the producer threads. The output goes
+ * to /dev/null, so that the disk doesn't dominate. */
+
+typedef std::chrono::steady_clock timer;
+
+static const std::size_t messages_per_thread = 200000;
+
+struct direct_impl
+{
+	explicit direct_impl(FILE* file) : file_(file) { }
+	void operator()(std::size_t thread, std::size_t i)
+	{
+		const std::string line = formatting::format("thread {} message {} value {}\n", thread, i, i * 0.5);
+		fwrite(line.data(), 1, line.size(), file_);
+	}
+	FILE* file_;
+};
+
+struct sink_format_impl
+{
+	explicit sink_format_impl(formatting::async_sink& sink) : sink_(sink) { }
+	void operator()(std::size_t thread, std::size_t i)
+	{
+		sink_.format("thread {} message {} value {}\n", thread, i, i * 0.5);
+	}
+	formatting::async_sink& sink_;
+};
+
+struct sink_capture_impl
+{
+	explicit sink_capture_impl(formatting::async_sink& sink) : sink_(sink) { }
+	void operator()(std::size_t thread, std::size_t i)
+	{
+		static const formatting::deferred_format line("thread {} message {} value {}\n");
+		sink_.capture(line, thread, i, i * 0.5);
+	}
+	formatting::async_sink& sink_;
+};
+
+/** Runs the producers and prints latency percentiles of single 
+ * calls and the total throughput. */
+template <typename Impl, typename Flush>
+void benchmark(const char* name, std::size_t n_threads, Impl impl, Flush flush)
+{
+	std::vector<std::vector<double> > latencies(n_threads, std::vector<double>(messages_per_thread));
+	std::vector<std::thread> producers;
+	const timer::time_point start = timer::now();
+	for (std::size_t t=0; t<n_threads; t++)
+		producers.push_back(std::thread([&latencies, &impl, t]()
+		{
+			Impl producer = impl;
+			for (std::size_t i=0; i<messages_per_thread; i++)
+			{
+				const timer::time_point call = timer::now();
+				producer(t, i);
+				latencies[t][i] = std::chrono::duration<double, std::nano>(timer::now() - call).count();
+			}
+		}));
+	for (std::size_t t=0; t<n_threads; t++)
+		producers[t].join();
+	flush();
+	const double seconds = std::chrono::duration<double>(timer::now() - start).count();
+
+	std::vector<double> all;
+	for (std::size_t t=0; t<n_threads; t++)
+		all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+	std::sort(all.begin(), all.end());
+	const double n = static_cast<double>(all.size());
+	printf("%-14s %2lu threads: %6.2f M msg/s, p50 %6.0f ns, p99 %7.0f ns, p99.9 %8.0f ns\n",
+		name, static_cast<unsigned long>(n_threads), n / seconds / 1e6,
+		all[static_cast<std::size_t>(n * 0.5)], all[static_cast<std::size_t>(n * 0.99)],
+		all[static_cast<std::size_t>(n * 0.999)]);
+}
+
+int main()
+{
+	FILE* null = fopen("/dev/null", "wb");
+	if (null == NULL)
+		return 1;
+	const std::size_t max_threads = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+	for (std::size_t n_threads=1; n_threads<=max_threads; n_threads*=2)
+	{
+		benchmark("format+fwrite", n_threads, direct_impl(null), [null]() { fflush(null); });
+		{
+			formatting::async_sink sink(null, 1 << 16);
+			benchmark("sink.format", n_threads, sink_format_impl(sink), [&sink]() { sink.flush(); });
+		}
+		{
+			formatting::async_sink sink(null, 1 << 16);
+			benchmark("sink.capture", n_threads, sink_capture_impl(sink), [&sink]() { sink.flush(); });
+		}
+	}
+	fclose(null);
+}
@@ -1,7 +1,43 @@
 #include <stdio.h>
 #include <sstream>
+#include <iomanip>
 #include <ctime>
+#include <cstdlib>
+#include <new>
 #include <formatting/formatting.hpp>
+#include <formatting/log.hpp>
+#include <formatting/columns.hpp>
+
+/** Number of heap allocations made so far. */
+static unsigned long allocations = 0;
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+	if (void* ptr = malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+/* GCC takes free() of the pointer operator delete gets for a 
+ * mismatch with operator new, while here both are replaced 
+ * with malloc and free and so are paired correctly. */
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) throw()
+{
+	free(ptr);
+}
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, std::size_t) throw()
+{
+	operator delete(ptr);
+}
+#endif
 
 struct sprintf_impl
 {
@@ -40,6 +76,323 @@ struct formatting_impl
 	}
 };
 
+struct compiled_formatting_impl
+{
+	compiled_formatting_impl() :
+		compiled("hello {} hello {} hello {} hello")
+	{
+	}
+	void operator()()
+	{
+		int a = 3;
+		char b = 'b';
+		const char* c = "test string";
+		std::string formatted = compiled(a, b, c);
+	}
+	const formatting::compiled_format<3> compiled;
+};
+
+#ifdef FMTG_USE_CXX11
+struct static_formatting_impl
+{
+	void operator()()
+	{
+		int a = 3;
+		char b = 'b';
+		const char* c = "test string";
+		std::string formatted = 
+			FMTG_FORMAT("hello {} hello {} hello {} hello")(a, b, c);
+	}
+};
+#endif
+
+/** Multi-kilobyte template with JSON-like fields. */
+std::string long_template()
+{
+	std::string fmt = "{";
+	for (int i=0; i<10; i++)
+	{
+		fmt += "\"field_with_a_rather_long_descriptive_name\": {}, ";
+		fmt += "\"static_field_with_a_constant_value\": \"lorem ipsum dolor sit amet, consectetur adipiscing elit\", ";
+		fmt += "\"another_static_field\": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16], ";
+	}
+	fmt += "}";
+	return fmt;
+}
+
+/** Previous implementation that replaced placeholders in a copy
+ * of the formatting string. */
+std::string replace_format(const std::string& fmt, const formatting::ValueWrapper** handlers, size_t n_handlers)
+{
+	std::string formatted = fmt;
+	size_t placeholder_position = 0;
+	for (size_t i=0; i<n_handlers; i++)
+	{
+		placeholder_position = formatted.find(formatting::placeholder, placeholder_position);
+		const std::string representation = handlers[i]->representation();
+		formatted.replace(placeholder_position, formatting::placeholder.length(), representation);
+		placeholder_position += representation.length();
+	}
+	return formatted;
+}
+
+struct long_replace_impl
+{
+	long_replace_impl() : fmt(long_template()) { }
+	void operator()()
+	{
+		int a = 3;
+		const char* b = "test string";
+		const formatting::ValueWrapper wa(a), wb(b);
+		const formatting::ValueWrapper* handlers[] = {&wa, &wb, &wa, &wb, &wa, &wb, &wa, &wb, &wa, &wb};
+		std::string formatted = replace_format(fmt, handlers, 10);
+	}
+	const std::string fmt;
+};
+
+struct long_formatting_impl
+{
+	long_formatting_impl() : fmt(long_template()) { }
+	void operator()()
+	{
+		int a = 3;
+		const char* b = "test string";
+		std::string formatted = formatting::format(fmt, a, b, a, b, a, b, a, b, a, b);
+	}
+	const std::string fmt;
+};
+
+/** HTML page of 64K with a few fields, mostly literal text. */
+std::string html_template()
+{
+	std::string fmt = "<html><head><title>{}</title></head><body>";
+	while (fmt.length() < 64 * 1024)
+		fmt += "<div class=\"row\"><span class=\"label\">Lorem ipsum dolor sit amet</span>"
+		       "<span class=\"value\">consectetur adipiscing elit, sed do eiusmod</span></div>\n";
+	fmt += "<p>{} of {}</p><footer>{}</footer></body></html>";
+	return fmt;
+}
+
+struct html_formatting_impl
+{
+	html_formatting_impl() : fmt(html_template()) { }
+	void operator()()
+	{
+		std::string formatted = formatting::format(fmt, "title", 1, 2, "footer");
+	}
+	const std::string fmt;
+};
+
+/** Integers of various lengths and types. */
+struct integers
+{
+	integers() : a(0), b(7), c(-42), d(1234), e(-987654), f(2147483647u), 
+		g(-1L), h(123456789012LL), i(-9223372036854775807LL) { }
+	int a, b, c, d, e;
+	unsigned int f;
+	long g;
+	long long h, i;
+};
+
+struct integers_streams_impl
+{
+	void operator()()
+	{
+		std::stringstream ss;
+		ss << v.a << ' ' << v.b << ' ' << v.c << ' ' << v.d << ' ' << v.e << ' ' 
+		   << v.f << ' ' << v.g << ' ' << v.h << ' ' << v.i;
+		volatile std::string s = ss.str();
+	}
+	integers v;
+};
+
+#ifdef FMTG_USE_CXX11
+struct integers_to_string_impl
+{
+	void operator()()
+	{
+		std::string s;
+		s += std::to_string(v.a); s += ' ';
+		s += std::to_string(v.b); s += ' ';
+		s += std::to_string(v.c); s += ' ';
+		s += std::to_string(v.d); s += ' ';
+		s += std::to_string(v.e); s += ' ';
+		s += std::to_string(v.f); s += ' ';
+		s += std::to_string(v.g); s += ' ';
+		s += std::to_string(v.h); s += ' ';
+		s += std::to_string(v.i);
+		volatile std::string result = s;
+	}
+	integers v;
+};
+#endif
+
+struct integers_formatting_impl
+{
+	void operator()()
+	{
+		volatile std::string s = formatting::format("{} {} {} {} {} {} {} {} {}", 
+			v.a, v.b, v.c, v.d, v.e, v.f, v.g, v.h, v.i);
+	}
+	integers v;
+};
+
+/** Floating point numbers like metrics samples. */
+struct doubles
+{
+	doubles() : a(0.1), b(-2.718281828459045), c(1234.5), d(6.02214076e23), e(1e-7) { }
+	double a, b, c, d, e;
+};
+
+struct doubles_streams_impl
+{
+	void operator()()
+	{
+		std::stringstream ss;
+		ss << std::setprecision(17) << v.a << ' ' << v.b << ' ' << v.c << ' ' << v.d << ' ' << v.e;
+		volatile std::string s = ss.str();
+	}
+	doubles v;
+};
+
+#ifdef FMTG_USE_CXX11
+struct doubles_to_string_impl
+{
+	void operator()()
+	{
+		std::string s;
+		s += std::to_string(v.a); s += ' ';
+		s += std::to_string(v.b); s += ' ';
+		s += std::to_string(v.c); s += ' ';
+		s += std::to_string(v.d); s += ' ';
+		s += std::to_string(v.e);
+		volatile std::string result = s;
+	}
+	doubles v;
+};
+#endif
+
+struct doubles_formatting_impl
+{
+	void operator()()
+	{
+		volatile std::string s = formatting::format("{} {} {} {} {}", v.a, v.b, v.c, v.d, v.e);
+	}
+	doubles v;
+};
+
+struct doubles_precision_streams_impl
+{
+	void operator()()
+	{
+		std::stringstream ss;
+		ss << std::setprecision(6) << v.a << ' ' << v.b << ' ' << v.c << ' ' << v.d << ' ' << v.e;
+		volatile std::string s = ss.str();
+	}
+	doubles v;
+};
+
+struct doubles_precision_formatting_impl
+{
+	void operator()()
+	{
+		using formatting::precision;
+		volatile std::string s = formatting::format("{} {} {} {} {}", precision[6](v.a), 
+			precision[6](v.b), precision[6](v.c), precision[6](v.d), precision[6](v.e));
+	}
+	doubles v;
+};
+
+#ifdef FMTG_USE_CXX11
+struct memory_buffer_formatting_impl
+{
+	void operator()()
+	{
+		int a = 3;
+		char b = 'b';
+		const char* c = "test string";
+		line.clear();
+		formatting::format_to(line, "hello {} hello {} hello {} hello", a, b, c);
+	}
+	static formatting::memory_buffer line;
+};
+formatting::memory_buffer memory_buffer_formatting_impl::line;
+#endif
+
+#ifdef FMTG_USE_CXX11
+/** Accessor that is too expensive to call for nothing. */
+static volatile int accessed = 0;
+int expensive_accessor()
+{
+	for (int i=0; i<100; i++)
+		accessed = accessed + 1;
+	return accessed;
+}
+
+struct disabled_log_impl
+{
+	void operator()()
+	{
+		FMTG_DEBUG("value {} and {}", expensive_accessor(), "text");
+	}
+};
+
+struct disabled_format_impl
+{
+	void operator()()
+	{
+		std::string line = formatting::format("value {} and {}", expensive_accessor(), "text");
+		if (formatting::log_enabled(formatting::debug_level))
+			fwrite(line.data(), 1, line.size(), stderr);
+	}
+};
+#endif
+
+#ifdef FMTG_USE_CXX11
+/** Columns of a CSV export. */
+struct csv_columns
+{
+	csv_columns() : ids(rows), values(rows), names(rows)
+	{
+		for (std::size_t i=0; i<rows; i++)
+		{
+			ids[i] = static_cast<long long>(i * 7919);
+			values[i] = i * 0.25 - 1000.0;
+			names[i] = i % 2 ? "sensor" : "meter";
+		}
+	}
+	static const std::size_t rows = 1000;
+	std::vector<long long> ids;
+	std::vector<double> values;
+	std::vector<const char*> names;
+};
+
+struct csv_rows_impl
+{
+	void operator()()
+	{
+		out.clear();
+		for (std::size_t i=0; i<csv_columns::rows; i++)
+			formatting::format_to(out, "{},{},{}\n", v.ids[i], v.values[i], v.names[i]);
+	}
+	csv_columns v;
+	static formatting::memory_buffer out;
+};
+formatting::memory_buffer csv_rows_impl::out;
+
+struct csv_columns_impl
+{
+	void operator()()
+	{
+		out.clear();
+		formatting::format_columns_to(out, "{},{},{}\n", csv_columns::rows, v.ids, v.values, v.names);
+	}
+	csv_columns v;
+	static formatting::memory_buffer out;
+};
+formatting::memory_buffer csv_columns_impl::out;
+#endif
+
 template <class T>
 clock_t benchmark(T impl, int n_times)
 {
@@ -59,4 +412,60 @@ int main()
 	printf("Streams takes %f\n", double(streams_time)/CLOCKS_PER_SEC);
 	clock_t formatting_time = benchmark(formatting_impl(), repeats);
 	printf("Formatting takes %f\n", double(formatting_time)/CLOCKS_PER_SEC);
+#ifdef FMTG_USE_CXX11
+	unsigned long allocations_before = allocations;
+	clock_t memory_buffer_formatting_time = benchmark(memory_buffer_formatting_impl(), repeats);
+	printf("Memory buffer formatting takes %f (%lu allocations)\n", 
+		double(memory_buffer_formatting_time)/CLOCKS_PER_SEC, allocations - allocations_before);
+#endif
+	clock_t compiled_formatting_time = benchmark(compiled_formatting_impl(), repeats);
+	printf("Compiled formatting takes %f\n", double(compiled_formatting_time)/CLOCKS_PER_SEC);
+	clock_t long_replace_time = benchmark(long_replace_impl(), repeats);
+	printf("Long template replacing takes %f\n", double(long_replace_time)/CLOCKS_PER_SEC);
+	clock_t long_formatting_time = benchmark(long_formatting_impl(), repeats);
+	printf("Long template formatting takes %f\n", double(long_formatting_time)/CLOCKS_PER_SEC);
+#ifdef FMTG_USE_CXX11
+	formatting::enable_format_cache();
+	clock_t cached_formatting_time = benchmark(formatting_impl(), repeats);
+	printf("Formatting with the format cache takes %f\n", double(cached_formatting_time)/CLOCKS_PER_SEC);
+	clock_t long_cached_formatting_time = benchmark(long_formatting_impl(), repeats);
+	printf("Long template formatting with the format cache takes %f\n", double(long_cached_formatting_time)/CLOCKS_PER_SEC);
+	formatting::enable_format_cache(false);
+#endif
+	const int html_repeats = 2000;
+	clock_t html_formatting_time = benchmark(html_formatting_impl(), html_repeats);
+	printf("Large template formatting runs at %.0f MB/s\n", 
+		double(html_template().length()) * html_repeats / 1e6 / (double(html_formatting_time)/CLOCKS_PER_SEC));
+	clock_t integers_streams_time = benchmark(integers_streams_impl(), repeats);
+	printf("Integers with streams take %f\n", double(integers_streams_time)/CLOCKS_PER_SEC);
+#ifdef FMTG_USE_CXX11
+	clock_t integers_to_string_time = benchmark(integers_to_string_impl(), repeats);
+	printf("Integers with to_string take %f\n", double(integers_to_string_time)/CLOCKS_PER_SEC);
+#endif
+	clock_t integers_formatting_time = benchmark(integers_formatting_impl(), repeats);
+	printf("Integers with formatting take %f\n", double(integers_formatting_time)/CLOCKS_PER_SEC);
+	clock_t doubles_streams_time = benchmark(doubles_streams_impl(), repeats);
+	printf("Doubles with streams take %f\n", double(doubles_streams_time)/CLOCKS_PER_SEC);
+#ifdef FMTG_USE_CXX11
+	clock_t doubles_to_string_time = benchmark(doubles_to_string_impl(), repeats);
+	printf("Doubles with to_string take %f\n", double(doubles_to_string_time)/CLOCKS_PER_SEC);
+#endif
+	clock_t doubles_formatting_time = benchmark(doubles_formatting_impl(), repeats);
+	printf("Doubles with formatting take %f\n", double(doubles_formatting_time)/CLOCKS_PER_SEC);
+	clock_t doubles_precision_streams_time = benchmark(doubles_precision_streams_impl(), repeats);
+	printf("Doubles with streams precision take %f\n", double(doubles_precision_streams_time)/CLOCKS_PER_SEC);
+	clock_t doubles_precision_formatting_time = benchmark(doubles_precision_formatting_impl(), repeats);
+	printf("Doubles with formatting precision take %f\n", double(doubles_precision_formatting_time)/CLOCKS_PER_SEC);
+#ifdef FMTG_USE_CXX11
+	clock_t static_formatting_time = benchmark(static_formatting_impl(), repeats);
+	printf("Static formatting takes %f\n", double(static_formatting_time)/CLOCKS_PER_SEC);
+	clock_t csv_rows_time = benchmark(csv_rows_impl(), repeats / 100);
+	printf("CSV rows one by one take %f\n", double(csv_rows_time)/CLOCKS_PER_SEC);
+	clock_t csv_columns_time = benchmark(csv_columns_impl(), repeats / 100);
+	printf("CSV rows from columns take %f\n", double(csv_columns_time)/CLOCKS_PER_SEC);
+	clock_t disabled_format_time = benchmark(disabled_format_impl(), repeats);
+	printf("Disabled formatting takes %f\n", double(disabled_format_time)/CLOCKS_PER_SEC);
+	clock_t disabled_log_time = benchmark(disabled_log_impl(), repeats * 100);
+	printf("Disabled log statement takes %f for 100 times more calls\n", double(disabled_log_time)/CLOCKS_PER_SEC);
+#endif
 }
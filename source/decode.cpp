@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <formatting/deferred.hpp>
+
+/** Decodes records written by formatting::deferred_format, 
+ * the file has to start with the template records written by 
+ * formatting::write_templates. Every entry is written as a line.
+ *
+ * Usage: formatting_decode [file], reads stdin without file.
+ */
+int main(int argc, char** argv)
+{
+	FILE* input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+	if (input == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", argv[1]);
+		return 1;
+	}
+	std::vector<char> data;
+	char chunk[4096];
+	std::size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), input)) != 0)
+		data.insert(data.end(), chunk, chunk + n);
+	if (input != stdin)
+		fclose(input);
+
+	std::map<std::uint32_t, std::string> templates;
+	formatting::memory_buffer line;
+	const char* p = data.data();
+	const char* end = p + data.size();
+	while (p != end)
+	{
+		const char* record_end = formatting::record_end(p, end);
+		if (record_end == NULL)
+		{
+			fprintf(stderr, "Malformed record at offset %lu\n", static_cast<unsigned long>(p - data.data()));
+			return 1;
+		}
+		if (formatting::is_template_record(p))
+			templates[formatting::record_id(p)] = formatting::template_string(p);
+		else
+		{
+			line.clear();
+			std::map<std::uint32_t, std::string>::const_iterator found = templates.find(formatting::record_id(p));
+			if (found == templates.end())
+				formatting::mark_errors()(line, formatting::unknown_template, NULL, 0);
+			else
+				formatting::render<formatting::mark_errors>(line, p, found->second);
+			line.push_back('\n');
+			fwrite(line.data(), 1, line.size(), stdout);
+		}
+		p = record_end;
+	}
+	return 0;
+}
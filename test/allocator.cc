@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+
+#ifdef FMTG_USE_CXX11
+template <typename T>
+struct counting_allocator
+{
+	typedef T value_type;
+
+	explicit counting_allocator(std::size_t* allocated) : allocated_(allocated) { }
+	template <typename U>
+	counting_allocator(const counting_allocator<U>& other) : allocated_(other.allocated_) { }
+
+	T* allocate(std::size_t n)
+	{
+		*allocated_ += n;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* ptr, std::size_t n)
+	{
+		std::allocator<T>().deallocate(ptr, n);
+	}
+	template <typename U>
+	bool operator==(const counting_allocator<U>& other) const { return allocated_ == other.allocated_; }
+	template <typename U>
+	bool operator!=(const counting_allocator<U>& other) const { return allocated_ != other.allocated_; }
+
+	std::size_t* allocated_;
+};
+
+TEST(Allocator,String)
+{
+	std::size_t allocated = 0;
+	const std::string long_string(100, 'x');
+	const auto result = formatting::format(counting_allocator<char>(&allocated), "{} {}", long_string, 42);
+	ASSERT_EQ(std::string(result.data(), result.size()), long_string + " 42");
+	ASSERT_GE(allocated, 103u);
+}
+TEST(Allocator,StringFormattingString)
+{
+	const std::string fmt = "{} {}";
+	ASSERT_EQ(formatting::format(fmt, "hey", 1), "hey 1");
+	ASSERT_EQ(formatting::format(std::allocator<char>(), fmt, "hey", 1), "hey 1");
+}
+TEST(Allocator,MemoryBuffer)
+{
+	std::size_t allocated = 0;
+	formatting::basic_memory_buffer<4, counting_allocator<char> > buffer((counting_allocator<char>(&allocated)));
+	formatting::format_to(buffer, "{}", 7);
+	ASSERT_EQ(allocated, 0u);
+	formatting::format_to(buffer, " {}", "mister");
+	ASSERT_EQ(buffer.str(), "7 mister");
+	ASSERT_GE(allocated, 8u);
+}
+#endif
+
+#ifdef FMTG_USE_CXX17
+TEST(Allocator,MemoryResource)
+{
+	char arena[1024];
+	std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+	const std::pmr::string result = formatting::format(&resource, "{} is {}", std::string(50, 'x'), 42);
+	ASSERT_EQ(std::string(result.data(), result.size()), std::string(50, 'x') + " is 42");
+	ASSERT_GE(result.data(), arena);
+	ASSERT_LT(result.data(), arena + sizeof(arena));
+}
+#endif
@@ -62,7 +62,31 @@ TEST(API,TenParameters)
 	ASSERT_NO_THROW(result = formatting::format("{} {} {} {} {} {} {} {} {} {}", 1, '2', "3", 4, '5', "6", 7, '8', 9, "10"));
 	ASSERT_STREQ(result.c_str(),"1 2 3 4 5 6 7 8 9 10");
 }
+#ifdef FMTG_USE_CXX11
+TEST(API,NoParameters)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("a {{}} b"));
+	ASSERT_STREQ(result.c_str(),"a {} b");
+	ASSERT_THROW(formatting::format("{}"), formatting::formatting_error);
+}
+TEST(API,TwelveParameters)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {} {} {} {} {} {} {} {} {}", 1, '2', "3", 4, '5', "6", 7, '8', 9, "10", 11u, 12l));
+	ASSERT_STREQ(result.c_str(),"1 2 3 4 5 6 7 8 9 10 11 12");
+}
+#endif
 TEST(API,WrongNumberOfPlaceholders)
 {
 	ASSERT_THROW(formatting::format("{}", 1, 2), formatting::formatting_error);
 }
+TEST(API,ValueWrapperCopy)
+{
+	const int value = 42;
+	const formatting::ValueWrapper wrapper(value);
+	const formatting::ValueWrapper copy(wrapper);
+	ASSERT_STREQ(wrapper.representation().c_str(),"42");
+	ASSERT_STREQ(copy.representation().c_str(),"42");
+	ASSERT_STREQ(formatting::ValueWrapper().representation().c_str(),"invalid argument");
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <formatting/async.hpp>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef FMTG_USE_CXX11
+
+namespace
+{
+	/** Writer that collects the text and can hold the consumer. */
+	struct collector
+	{
+		collector() : held_(false)
+		{
+		}
+		formatting::async_sink::writer writer()
+		{
+			return [this](const char* data, std::size_t length)
+			{
+				while (held_.load())
+					std::this_thread::yield();
+				text_.append(data, length);
+			};
+		}
+		std::string text_;
+		std::atomic<bool> held_;
+	};
+
+	/** Throws while it is captured. */
+	struct faulty
+	{
+	};
+	/** Holds the slot it is formatted into until it is opened. */
+	struct gate
+	{
+		std::atomic<bool>* entered_;
+		std::atomic<bool>* opened_;
+	};
+}
+namespace formatting
+{
+	template <>
+	struct formatter<faulty>
+	{
+		void operator()(buffer&, const faulty&) const
+		{
+			throw std::runtime_error("faulty");
+		}
+		std::size_t size_hint(const faulty&) const
+		{
+			return 0;
+		}
+	};
+	template <>
+	struct formatter<gate>
+	{
+		void operator()(buffer&, const gate& value) const
+		{
+			value.entered_->store(true);
+			while (!value.opened_->load())
+				std::this_thread::yield();
+		}
+		std::size_t size_hint(const gate&) const
+		{
+			return 0;
+		}
+	};
+}
+namespace
+{
+	/** Checks that every producer's numbers are written in order. */
+	void expectOrdered(const std::string& text, std::size_t n_producers, std::size_t n_messages)
+	{
+		std::vector<std::size_t> next(n_producers, 0);
+		std::istringstream lines(text);
+		std::size_t producer, number;
+		while (lines >> producer >> number)
+		{
+			ASSERT_LT(producer, n_producers);
+			ASSERT_EQ(number, next[producer]);
+			next[producer]++;
+		}
+		for (std::size_t i=0; i<n_producers; i++)
+			ASSERT_EQ(next[i], n_messages);
+	}
+}
+
+TEST(Async,Messages)
+{
+	collector output;
+	formatting::async_sink sink(output.writer(), 16);
+	static const formatting::deferred_format line("{} is {:.2f}\n");
+	ASSERT_TRUE(sink.format("{} is {}\n", "x", 42));
+	ASSERT_TRUE(sink.write("text\n"));
+	ASSERT_TRUE(sink.capture(line, "pi", 3.14159));
+	sink.flush();
+	ASSERT_EQ(output.text_, "x is 42\ntext\npi is 3.14\n");
+}
+TEST(Async,LongMessages)
+{
+	collector output;
+	formatting::async_sink sink(output.writer(), 4);
+	const std::string text(10000, 'a');
+	for (int i=0; i<10; i++)
+		sink.format("{}{}", text, i);
+	sink.flush();
+	ASSERT_EQ(output.text_.size(), 10 * 10001u);
+}
+TEST(Async,Errors)
+{
+	collector output;
+	formatting::async_sink sink(output.writer(), 4);
+	ASSERT_THROW(sink.format("{} {}\n", 1), formatting::formatting_error);
+	ASSERT_TRUE(sink.format<formatting::mark_errors>("{} {}\n", 2));
+	static const formatting::deferred_format line("{} {}\n");
+	ASSERT_TRUE(sink.capture(line, 3));
+	sink.flush();
+	ASSERT_EQ(output.text_, "2 {!missing argument}\n3 {!missing argument}\n");
+}
+TEST(Async,ThrowingCapture)
+{
+	collector output;
+	formatting::async_sink sink(output.writer(), 4);
+	static const formatting::deferred_format line("{} {}\n");
+	for (int i=0; i<6; i++)
+	{
+		ASSERT_THROW(sink.capture(line, i, faulty()), std::runtime_error);
+		ASSERT_TRUE(sink.capture(line, i, "ok"));
+	}
+	sink.flush();
+	ASSERT_EQ(output.text_, "0 ok\n1 ok\n2 ok\n3 ok\n4 ok\n5 ok\n");
+}
+TEST(Async,Producers)
+{
+	const std::size_t n_producers = 4, n_messages = 10000;
+	collector output;
+	{
+		formatting::async_sink sink(output.writer(), 64);
+		std::vector<std::thread> producers;
+		for (std::size_t i=0; i<n_producers; i++)
+			producers.push_back(std::thread([&sink, i, n_messages]()
+			{
+				for (std::size_t j=0; j<n_messages; j++)
+					sink.format("{} {}\n", i, j);
+			}));
+		for (std::size_t i=0; i<n_producers; i++)
+			producers[i].join();
+	}
+	expectOrdered(output.text_, n_producers, n_messages);
+}
+TEST(Async,Drop)
+{
+	collector output;
+	output.held_ = true;
+	std::size_t accepted = 0;
+	{
+		formatting::async_sink sink(output.writer(), 8, formatting::drop_on_overflow);
+		for (int i=0; i<100; i++)
+			accepted += sink.format("{}\n", i) ? 1 : 0;
+		ASSERT_EQ(accepted + sink.dropped(), 100u);
+		ASSERT_GT(sink.dropped(), 0u);
+		output.held_ = false;
+	}
+	ASSERT_EQ(static_cast<std::size_t>(std::count(output.text_.begin(), output.text_.end(), '\n')), accepted);
+}
+TEST(Async,Grow)
+{
+	const std::size_t n_producers = 3, n_messages = 1000;
+	collector output;
+	output.held_ = true;
+	{
+		formatting::async_sink sink(output.writer(), 8, formatting::grow_on_overflow);
+		std::vector<std::thread> producers;
+		for (std::size_t i=0; i<n_producers; i++)
+			producers.push_back(std::thread([&sink, i, n_messages]()
+			{
+				for (std::size_t j=0; j<n_messages; j++)
+					ASSERT_TRUE(sink.format("{} {}\n", i, j));
+			}));
+		for (std::size_t i=0; i<n_producers; i++)
+			producers[i].join();
+		ASSERT_EQ(sink.dropped(), 0u);
+		output.held_ = false;
+		sink.flush();
+		expectOrdered(output.text_, n_producers, n_messages);
+	}
+}
+TEST(Async,GrowKeepsOrder)
+{
+	const std::size_t n_messages = 100;
+	collector output;
+	{
+		formatting::async_sink sink(output.writer(), 4, formatting::grow_on_overflow);
+		// the other producer holds the slot the consumer reads next
+		std::atomic<bool> entered(false), opened(false);
+		std::thread holder([&sink, &entered, &opened]()
+		{
+			sink.format("{}", gate{&entered, &opened});
+		});
+		while (!entered.load())
+			std::this_thread::yield();
+		for (std::size_t j=0; j<n_messages; j++)
+			ASSERT_TRUE(sink.format("0 {}\n", j));
+		opened = true;
+		holder.join();
+		sink.flush();
+		expectOrdered(output.text_, 1, n_messages);
+	}
+}
+#endif
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef FMTG_USE_CXX11
+
+using formatting::arg;
+
+namespace
+{
+	/** Formats with the cache while it is being formatted and
+	 * evicts all formats, including the one of the outer call. */
+	struct evicting
+	{
+	};
+}
+namespace formatting
+{
+	template <>
+	struct formatter<evicting>
+	{
+		void operator()(buffer& out, const evicting&) const
+		{
+			std::string inner;
+			for (int i=0; i<600; i++)
+			{
+				clear_format_cache();
+				inner = format("inner {}", i);
+			}
+			out.append(inner);
+		}
+		std::size_t size_hint(const evicting&) const
+		{
+			return 9;
+		}
+	};
+}
+namespace
+{
+	struct CacheTest : public ::testing::Test
+	{
+		void SetUp()
+		{
+			formatting::clear_format_cache();
+			formatting::enable_format_cache();
+		}
+		void TearDown()
+		{
+			formatting::enable_format_cache(false);
+		}
+	};
+}
+
+TEST_F(CacheTest,HitsAndMisses)
+{
+	const formatting::format_cache_statistics before = formatting::format_cache_stats();
+	const std::string fmt = "{} is {:>4} {{}}";
+	for (int i=0; i<10; i++)
+		ASSERT_EQ(formatting::format(fmt, "x", i), "x is    " + std::to_string(i) + " {}");
+	const formatting::format_cache_statistics after = formatting::format_cache_stats();
+	ASSERT_EQ(after.misses_ - before.misses_, 1u);
+	ASSERT_EQ(after.hits_ - before.hits_, 9u);
+}
+TEST_F(CacheTest,SameContent)
+{
+	const formatting::format_cache_statistics before = formatting::format_cache_stats();
+	for (int i=0; i<5; i++)
+	{
+		const std::string fmt = std::string("{who}") + " is {age}";
+		ASSERT_EQ(formatting::format(fmt, arg("who", "x"), arg("age", i)), "x is " + std::to_string(i));
+	}
+	ASSERT_EQ(formatting::format_cache_stats().misses_ - before.misses_, 1u);
+}
+TEST_F(CacheTest,Errors)
+{
+	for (int i=0; i<2; i++)
+	{
+		ASSERT_THROW(formatting::format("{} {}", 1), formatting::formatting_error);
+		ASSERT_THROW(formatting::format("{}", 1, 2), formatting::formatting_error);
+		ASSERT_EQ(formatting::format<formatting::mark_errors>("{} {}", 1), "1 {!missing argument}");
+		ASSERT_EQ(formatting::format<formatting::mark_errors>("{}", 1, 2), "1{!unused arguments}");
+		ASSERT_EQ(formatting::format<formatting::mark_errors>("{2} {who}", 1), 
+		          "{!index out of range} {!unknown name who}");
+	}
+}
+TEST_F(CacheTest,Eviction)
+{
+	const formatting::format_cache_statistics before = formatting::format_cache_stats();
+	for (int i=0; i<4 * FMTG_FORMAT_CACHE_SIZE; i++)
+	{
+		const std::string fmt = std::to_string(i) + " {}";
+		ASSERT_EQ(formatting::format(fmt, i), std::to_string(i) + " " + std::to_string(i));
+	}
+	const formatting::format_cache_statistics after = formatting::format_cache_stats();
+	ASSERT_EQ(after.misses_ - before.misses_, 4u * FMTG_FORMAT_CACHE_SIZE);
+	ASSERT_GE(after.evictions_ - before.evictions_, 3u * FMTG_FORMAT_CACHE_SIZE);
+}
+TEST_F(CacheTest,Nested)
+{
+	const std::string fmt = "{} then {} and {:>3}";
+	for (int i=0; i<2; i++)
+		ASSERT_EQ(formatting::format(fmt, evicting(), 1, 2), "inner 599 then 1 and   2");
+}
+TEST_F(CacheTest,Threads)
+{
+	std::vector<std::thread> threads;
+	std::vector<int> failures(8, 0);
+	for (int t=0; t<8; t++)
+		threads.push_back(std::thread([t, &failures]()
+		{
+			for (int i=0; i<2000; i++)
+			{
+				// a few shared strings and ones that keep evicting others
+				const std::string fmt = i % 4 == 0 ? std::to_string(t * 10000 + i) + " {}" : 
+				                        "shared " + std::to_string(i % 8) + " {}";
+				const std::string prefix = i % 4 == 0 ? std::to_string(t * 10000 + i) + " " : 
+				                           "shared " + std::to_string(i % 8) + " ";
+				if (formatting::format(fmt, i) != prefix + std::to_string(i))
+					failures[t]++;
+			}
+		}));
+	for (int t=0; t<8; t++)
+		threads[t].join();
+	for (int t=0; t<8; t++)
+		ASSERT_EQ(failures[t], 0);
+}
+TEST(Cache,Disabled)
+{
+	const formatting::format_cache_statistics before = formatting::format_cache_stats();
+	ASSERT_EQ(formatting::format("{} {}", 1, 2), "1 2");
+	const formatting::format_cache_statistics after = formatting::format_cache_stats();
+	ASSERT_EQ(after.hits_ + after.misses_, before.hits_ + before.misses_);
+}
+#endif
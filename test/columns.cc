@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <formatting/columns.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+
+#ifdef FMTG_USE_CXX11
+
+TEST(Columns,MatchesRows)
+{
+	const std::vector<int> ids = {1, -22, 333, 0};
+	const std::vector<double> values = {0.5, 1e21, -3.25, 0.1};
+	const std::vector<std::string> names = {"a", "bb", "", "dddd"};
+	const std::string fmt = "{},{},\"{}\"\n";
+	std::string expected;
+	for (std::size_t i=0; i<ids.size(); i++)
+		expected += formatting::format(fmt, ids[i], values[i], names[i]);
+	ASSERT_EQ(formatting::format_columns(fmt, ids.size(), ids, values, names), expected);
+}
+TEST(Columns,SpecsAndPositions)
+{
+	const std::vector<unsigned> flags = {1, 255, 4096};
+	const std::deque<float> ratios = {0.125f, 2.5f, 100.0f};
+	const char* labels[] = {"x", "yy", "zzz"};
+	const std::string fmt = "{1:>8.2f}|{0:#x}|{2:<4}|{0}|{0}|{2}";
+	std::string expected;
+	for (std::size_t i=0; i<3; i++)
+		expected += formatting::format(fmt, flags[i], ratios[i], labels[i]);
+	ASSERT_EQ(formatting::format_columns(fmt, 3, flags, ratios, labels), expected);
+}
+TEST(Columns,Pointers)
+{
+	const long long timestamps[] = {1700000000000LL, 1700000000001LL};
+	const std::array<bool, 2> up = {{true, false}};
+	const char states[] = {'u', 'd'};
+	const long long* pointer = timestamps;
+	ASSERT_EQ(formatting::format_columns("cpu up={} state={} {}\n", 2, up, states, pointer),
+	          "cpu up=true state=u 1700000000000\ncpu up=false state=d 1700000000001\n");
+}
+TEST(Columns,MemoryBuffer)
+{
+	const std::vector<int> a = {1, 2, 3};
+	formatting::memory_buffer out;
+	out.append(std::string("head\n"));
+	formatting::format_columns_to(out, "{{{}}}\n", 2, a);
+	ASSERT_EQ(out.str(), "head\n{1}\n{2}\n");
+	formatting::format_columns_to(out, "{}", 0, a);
+	ASSERT_EQ(out.str(), "head\n{1}\n{2}\n");
+}
+TEST(Columns,Errors)
+{
+	const std::vector<int> a = {1, 2};
+	ASSERT_THROW(formatting::format_columns("{} {}", 2, a), formatting::formatting_error);
+	ASSERT_THROW(formatting::format_columns("{}", 2, a, a), formatting::formatting_error);
+	ASSERT_THROW(formatting::format_columns("{name}", 2, a), formatting::formatting_error);
+	ASSERT_EQ(formatting::format_columns<formatting::mark_errors>("{} {};", 2, a),
+	          "1 {!missing argument};2 {!missing argument};");
+	ASSERT_EQ(formatting::format_columns<formatting::mark_errors>("{};", 2, a, a),
+	          "1;{!unused arguments}2;{!unused arguments}");
+	ASSERT_EQ(formatting::format_columns<formatting::mark_errors>("{who}={0};", 2, a),
+	          "{!unknown name who}=1;{!unknown name who}=2;");
+	ASSERT_EQ(formatting::format_columns<formatting::mark_errors>("{:q}{};", 2, a, a),
+	          "{!invalid spec}1;{!invalid spec}2;");
+	const std::vector<double> b = {0.5, 1.5};
+	ASSERT_EQ(formatting::format_columns<formatting::mark_errors>("{:x}{};", 2, b, a),
+	          "{!invalid spec}1;{!invalid spec}2;");
+}
+#endif
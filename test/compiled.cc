@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+
+TEST(Compiled,Apply)
+{
+	std::string result;
+	const formatting::compiled_format<3> compiled("{} + {} is {}");
+	ASSERT_NO_THROW(result = compiled(2, 2, 4));
+	ASSERT_STREQ(result.c_str(),"2 + 2 is 4");
+}
+TEST(Compiled,ApplyManyTimes)
+{
+	const formatting::compiled_format<2> compiled("hey {} howdy {}");
+	for (int i=0; i<3; i++)
+	{
+		std::string result = compiled(i, "mister");
+		ASSERT_STREQ(result.c_str(),formatting::format("hey {} howdy {}", i, "mister").c_str());
+	}
+}
+TEST(Compiled,FieldOnly)
+{
+	std::string result;
+	const formatting::compiled_format<1> compiled("{}");
+	ASSERT_NO_THROW(result = compiled("hey"));
+	ASSERT_STREQ(result.c_str(),"hey");
+}
+#ifdef FMTG_USE_CXX11
+TEST(Compiled,LiteralsOnly)
+{
+	ASSERT_EQ(formatting::compiled_format<0>("abc")(), "abc");
+	ASSERT_EQ(formatting::compiled_format<0>("a{{b}}")(), "a{b}");
+	ASSERT_EQ(formatting::compiled_format<0>("")(), "");
+	ASSERT_THROW(formatting::compiled_format<0>("a{}"), formatting::formatting_error);
+}
+#endif
+TEST(Compiled,WrongNumberOfPlaceholders)
+{
+	ASSERT_THROW(formatting::compiled_format<2>("{}"), formatting::formatting_error);
+	ASSERT_THROW(formatting::compiled_format<1>("{} {}"), formatting::formatting_error);
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <formatting/deferred.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+
+#ifdef FMTG_USE_CXX11
+
+using formatting::arg;
+
+namespace
+{
+	struct Point
+	{
+		int x_, y_;
+	};
+	std::ostream& operator<<(std::ostream& out, const Point& point)
+	{
+		return out << "(" << point.x_ << ";" << point.y_ << ")";
+	}
+
+	/** Captures the arguments and renders the record right away. */
+	template <typename... Args>
+	std::string deferred(const formatting::deferred_format& line, const Args&... args)
+	{
+		formatting::memory_buffer records;
+		line.capture(records, args...);
+		const std::string record = records.str();
+		const char* end = record.data() + record.size();
+		EXPECT_EQ(formatting::record_end(record.data(), end), end);
+		return formatting::render(record.data());
+	}
+}
+
+TEST(Deferred,Scalars)
+{
+	const std::string fmt = "{} {} {} {} {} {} {} {}";
+	const formatting::deferred_format line(fmt);
+	ASSERT_EQ(deferred(line, 1, -2L, 3u, 1.5f, 0.1, 2.5L, true, 'c'),
+	          formatting::format(fmt, 1, -2L, 3u, 1.5f, 0.1, 2.5L, true, 'c'));
+	ASSERT_EQ(deferred(line, static_cast<short>(-7), 18446744073709551615ull, -9223372036854775807ll, 
+	                   1e300, 5e-324, -0.0f, false, static_cast<unsigned char>('x')),
+	          formatting::format(fmt, static_cast<short>(-7), 18446744073709551615ull, -9223372036854775807ll,
+	                             1e300, 5e-324, -0.0f, false, static_cast<unsigned char>('x')));
+}
+TEST(Deferred,Strings)
+{
+	const formatting::deferred_format line("{}|{}|{}");
+	std::string copied = "copied";
+	char text[] = "array";
+	formatting::memory_buffer records;
+	line.capture(records, copied, text, "literal");
+	copied = "changed";
+	text[0] = 'A';
+	ASSERT_EQ(formatting::render(records.data()), "copied|array|literal");
+}
+TEST(Deferred,Containers)
+{
+	const std::string fmt = "{} {} {} {}";
+	const formatting::deferred_format line(fmt);
+	std::vector<int> numbers = {1, 2, 3};
+	std::map<std::string, double> values = {{"a", 0.5}, {"b", 2}};
+	std::vector<std::vector<std::string> > nested = {{"x"}, {}, {"y", "z"}};
+	std::pair<int, std::string> pair(4, "four");
+	ASSERT_EQ(deferred(line, numbers, values, nested, pair), 
+	          formatting::format(fmt, numbers, values, nested, pair));
+}
+TEST(Deferred,LongDoubleBytes)
+{
+	const formatting::deferred_format line("{}");
+	// the same value with different bytes after the significant ones
+	long double dirty, clean;
+	std::memset(&dirty, 0xff, sizeof(dirty));
+	std::memset(&clean, 0, sizeof(clean));
+	dirty = 2.5L;
+	clean = 2.5L;
+	formatting::memory_buffer first, second;
+	line.capture(first, dirty);
+	line.capture(second, clean);
+	ASSERT_EQ(first.str(), second.str());
+	ASSERT_EQ(formatting::render(first.data()), "2.5");
+}
+TEST(Deferred,Specs)
+{
+	const std::string fmt = "{:>6} {:+.2f} {:#x} {:<5}| {:08.3e}";
+	const formatting::deferred_format line(fmt);
+	ASSERT_EQ(deferred(line, 42, 3.14159, 255u, "ab", -1234.5),
+	          formatting::format(fmt, 42, 3.14159, 255u, "ab", -1234.5));
+}
+TEST(Deferred,Named)
+{
+	const std::string fmt = "{who} is {age} {0}";
+	const formatting::deferred_format line(fmt);
+	ASSERT_EQ(deferred(line, arg("who", std::string("Bob")), arg("age", 42)),
+	          formatting::format(fmt, arg("who", std::string("Bob")), arg("age", 42)));
+}
+TEST(Deferred,NamedElements)
+{
+	const std::string fmt = "{} after";
+	const formatting::deferred_format line(fmt);
+	const int five = 5, six = 6;
+	std::vector<decltype(arg("a", five))> named = {arg("a", five), arg("b", six)};
+	ASSERT_EQ(deferred(line, named), formatting::format(fmt, named));
+	ASSERT_EQ(deferred(line, named), "[5, 6] after");
+}
+TEST(Deferred,NestedNameBounds)
+{
+	const formatting::deferred_format line("{}");
+	formatting::memory_buffer captured;
+	line.capture(captured, 1LL);
+	const std::size_t header = 1 + sizeof(std::uint32_t) + 1;
+	const std::uint32_t two = 2, name_length = 0x73;
+	// a range of a named value and a bool
+	std::string record(captured.data(), header);
+	record += "r[]" + std::string(reinterpret_cast<const char*>(&two), sizeof(two));
+	record += "n" + std::string(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+	record += std::string(name_length, '\xff') + "b" + std::string(1, '\1') + "b" + std::string(1, '\0');
+	const char* end = record.data() + record.size();
+	ASSERT_EQ(formatting::record_end(record.data(), end), end);
+	ASSERT_EQ(formatting::render(record.data()), "[true, false]");
+	// the name runs past the record
+	const std::string truncated = record.substr(0, header + 3 + sizeof(two) + 1 + sizeof(name_length) + 10);
+	ASSERT_TRUE(formatting::record_end(truncated.data(), truncated.data() + truncated.size()) == NULL);
+}
+TEST(Deferred,OtherTypes)
+{
+	const std::string fmt = "{} {} {}";
+	const formatting::deferred_format line(fmt);
+	Point point = {1, 2};
+	formatting::memory_buffer records;
+	line.capture(records, point, formatting::hex(255), formatting::oct(8));
+	point.x_ = 5;
+	ASSERT_EQ(formatting::render(records.data()), formatting::format(fmt, Point{1, 2}, formatting::hex(255), formatting::oct(8)));
+}
+TEST(Deferred,Errors)
+{
+	const formatting::deferred_format line("{} {}");
+	formatting::memory_buffer records;
+	line.capture(records, 1);
+	ASSERT_THROW(formatting::render(records.data()), formatting::formatting_error);
+	ASSERT_EQ(formatting::render<formatting::mark_errors>(records.data()), "1 {!missing argument}");
+
+	const formatting::deferred_format typed("{:d} {:x}");
+	formatting::memory_buffer mistyped;
+	typed.capture(mistyped, 2.5, "str");
+	ASSERT_EQ(formatting::render<formatting::mark_errors>(mistyped.data()), "{!invalid spec} {!invalid spec}");
+
+	formatting::memory_buffer unknown;
+	unknown.push_back('E');
+	const std::uint32_t id = 0xFFFFFFFF;
+	unknown.append(reinterpret_cast<const char*>(&id), reinterpret_cast<const char*>(&id) + sizeof(id));
+	unknown.push_back('\0');
+	ASSERT_THROW(formatting::render(unknown.data()), formatting::formatting_error);
+	ASSERT_EQ(formatting::render<formatting::mark_errors>(unknown.data()), "{!unknown template}");
+	ASSERT_TRUE(formatting::record_end(records.data(), records.data() + records.size() - 1) == NULL);
+}
+TEST(Deferred,NestingDepth)
+{
+	const formatting::deferred_format line("{}");
+	formatting::memory_buffer captured;
+	line.capture(captured, 1LL);
+	const std::size_t header = 1 + sizeof(std::uint32_t) + 1;
+	// the captured value put in the given number of one element ranges
+	const auto nested = [&](std::size_t depth)
+	{
+		std::string record(captured.data(), header);
+		const std::uint32_t one = 1;
+		for (std::size_t i=0; i<depth; i++)
+			record += "r[]" + std::string(reinterpret_cast<const char*>(&one), sizeof(one));
+		return record + std::string(captured.data() + header, captured.size() - header);
+	};
+	const std::size_t max_depth = formatting::internal::max_captured_depth;
+	const std::string deepest = nested(max_depth);
+	ASSERT_EQ(formatting::record_end(deepest.data(), deepest.data() + deepest.size()), 
+	          deepest.data() + deepest.size());
+	ASSERT_EQ(formatting::render(deepest.data()), std::string(max_depth, '[') + "1" + std::string(max_depth, ']'));
+	const std::string deeper = nested(max_depth + 1);
+	ASSERT_TRUE(formatting::record_end(deeper.data(), deeper.data() + deeper.size()) == NULL);
+	const std::string hostile = nested(1000000);
+	ASSERT_TRUE(formatting::record_end(hostile.data(), hostile.data() + hostile.size()) == NULL);
+}
+TEST(Deferred,Templates)
+{
+	const formatting::deferred_format line("{} + {} = {}");
+	formatting::memory_buffer records;
+	formatting::write_templates(records);
+	line.capture(records, 1, 2.5, "3.5");
+	const char* end = records.data() + records.size();
+	std::map<std::uint32_t, std::string> templates;
+	std::string rendered;
+	for (const char* p = records.data(); p != end; p = formatting::record_end(p, end))
+	{
+		ASSERT_TRUE(formatting::record_end(p, end) != NULL);
+		if (formatting::is_template_record(p))
+			templates[formatting::record_id(p)] = formatting::template_string(p);
+		else
+		{
+			formatting::internal::string_buffer buffer(rendered);
+			formatting::render(buffer, p, templates[formatting::record_id(p)]);
+			buffer.finish();
+		}
+	}
+	ASSERT_EQ(rendered, "1 + 2.5 = 3.5");
+	ASSERT_EQ(templates[line.id()], "{} + {} = {}");
+}
+#endif
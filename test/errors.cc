@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+
+using formatting::arg;
+
+TEST(Errors,EscapedBraces)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{{}} {}", 1));
+	ASSERT_STREQ(result.c_str(),"{} 1");
+	ASSERT_NO_THROW(result = formatting::format("{{{}}}", 2));
+	ASSERT_STREQ(result.c_str(),"{2}");
+	ASSERT_NO_THROW(result = formatting::format("}}{{{{{}", 3));
+	ASSERT_STREQ(result.c_str(),"}{{3");
+	ASSERT_NO_THROW(result = formatting::format("{ } }{ {}", 4));
+	ASSERT_STREQ(result.c_str(),"{ } }{ 4");
+}
+TEST(Errors,EscapedBracesCompiled)
+{
+	const formatting::compiled_format<1> line("{{{}}} }}{{");
+	ASSERT_STREQ(line(1).c_str(),"{1} }{");
+}
+#ifdef FMTG_USE_CXX11
+TEST(Errors,EscapedBracesStatic)
+{
+	ASSERT_EQ(FMTG_FORMAT("{{{}}} {{}} {}")(1, 2), "{1} {} 2");
+	const auto escaped = FMTG_FORMAT("{{{{}}");
+	static_assert(decltype(escaped)::n_placeholders == 0, "");
+	ASSERT_EQ(escaped(), "{{}");
+}
+TEST(Errors,Throw)
+{
+	ASSERT_THROW(formatting::format("{} {}", 1), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{}", 1, 2), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{1}", 1), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{who}", 1), formatting::formatting_error);
+}
+TEST(Errors,Markers)
+{
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{} {}", 1), "1 {!missing argument}");
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{}", 1, 2), "1{!unused arguments}");
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{0} {3}", 1), "1 {!index out of range}");
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{who}", arg("what", 1)), "{!unknown name who}");
+
+	char out[32];
+	const std::size_t size = formatting::format_to_n<formatting::mark_errors>(out, sizeof(out), "{}{}", 1);
+	ASSERT_EQ(std::string(out, size), "1{!missing argument}");
+}
+TEST(Errors,TryFormat)
+{
+	std::string result;
+	ASSERT_EQ(formatting::try_format(result, "{} {}", 1, 2), formatting::no_error);
+	ASSERT_EQ(result, "1 2");
+	ASSERT_EQ(formatting::try_format(result, "{} {} {}", 1, 2), formatting::missing_argument);
+	ASSERT_EQ(result, "1 2 ");
+	ASSERT_EQ(formatting::try_format(result, "{}", 1, 2), formatting::unused_arguments);
+	ASSERT_EQ(formatting::try_format(result, "{2} {}", 1), formatting::index_out_of_range);
+	ASSERT_EQ(formatting::try_format(result, "{x}", 1), formatting::unknown_name);
+	ASSERT_EQ(formatting::try_format(result, "x"), formatting::no_error);
+	ASSERT_EQ(result, "x");
+	ASSERT_EQ(formatting::try_format(result, "{}"), formatting::missing_argument);
+	ASSERT_STREQ(formatting::error_message(formatting::index_out_of_range), "The argument index is out of range");
+}
+#endif
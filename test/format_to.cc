@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef FMTG_USE_CXX11
+TEST(FormatTo,BackInserter)
+{
+	std::vector<char> result;
+	ASSERT_NO_THROW(formatting::format_to(std::back_inserter(result), "hey {} howdy {}", 1, "mister"));
+	ASSERT_EQ(std::string(result.begin(), result.end()), "hey 1 howdy mister");
+}
+TEST(FormatTo,LongOutput)
+{
+	std::string result;
+	const std::string long_string(1000, 'x');
+	ASSERT_NO_THROW(formatting::format_to(std::back_inserter(result), "{} {}", long_string, long_string));
+	ASSERT_EQ(result, long_string + " " + long_string);
+}
+TEST(FormatTo,Pointer)
+{
+	char result[32];
+	char* end = formatting::format_to(result, "hey {} howdy", 42);
+	ASSERT_EQ(end - result, 12);
+	*end = '\0';
+	ASSERT_STREQ(result,"hey 42 howdy");
+}
+TEST(FormatTo,TruncatedToN)
+{
+	char result[8] = "-------";
+	std::size_t size = formatting::format_to_n(result, 4, "hey {} howdy", 42);
+	ASSERT_EQ(size, 12u);
+	ASSERT_STREQ(result,"hey ---");
+}
+TEST(FormatTo,FitsToN)
+{
+	char result[16];
+	std::size_t size = formatting::format_to_n(result, sizeof(result), "hey {} howdy", 42);
+	ASSERT_EQ(size, 12u);
+	ASSERT_EQ(std::string(result, size), "hey 42 howdy");
+}
+TEST(FormatTo,FormattedSize)
+{
+	const std::string long_string(1000, 'x');
+	ASSERT_EQ(formatting::formatted_size("hey {} howdy", 42), 12u);
+	ASSERT_EQ(formatting::formatted_size("{}{}", long_string, 1), 1001u);
+	ASSERT_THROW(formatting::formatted_size("{}", 1, 2), formatting::formatting_error);
+}
+TEST(FormatTo,NoArguments)
+{
+	std::string result;
+	formatting::format_to(std::back_inserter(result), "x");
+	ASSERT_EQ(result, "x");
+	ASSERT_EQ(formatting::formatted_size("x {{}}"), 4u);
+}
+#endif
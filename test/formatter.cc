@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <limits>
+#include <string>
+#include <vector>
+
+struct order_id
+{
+	explicit order_id(unsigned int number) : number(number) { }
+	unsigned int number;
+};
+
+/** Fixed-point price in cents that is numeric for the standard library. */
+struct price
+{
+	explicit price(long cents) : cents(cents) { }
+	long cents;
+};
+
+namespace std
+{
+	template <>
+	class numeric_limits<price> : public numeric_limits<long>
+	{
+	};
+}
+
+namespace formatting
+{
+	template <>
+	struct formatter<order_id>
+	{
+		void operator()(buffer& out, const order_id& id) const
+		{
+			out.push_back('#');
+			write(out, id.number);
+		}
+		std::size_t size_hint(const order_id&) const
+		{
+			return 11;
+		}
+	};
+	template <>
+	struct formatter<price>
+	{
+		void operator()(buffer& out, const price& value) const
+		{
+			write(out, value.cents / 100);
+			out.push_back('.');
+			write(out, width[2](value.cents % 100, '0'));
+		}
+		std::size_t size_hint(const price&) const
+		{
+			return 16;
+		}
+	};
+}
+
+TEST(Formatter,UserType)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("order {} costs {}", order_id(42), price(1205)));
+	ASSERT_STREQ(result.c_str(),"order #42 costs 12.05");
+}
+
+TEST(Formatter,Composed)
+{
+	std::vector<order_id> orders;
+	orders.push_back(order_id(1));
+	orders.push_back(order_id(2));
+	const order_id third(3);
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {}", orders, formatting::width[4](third, '_'), &third));
+	ASSERT_STREQ(result.c_str(),"[#1, #2] __#3 #3");
+}
+
+#ifdef FMTG_USE_CXX11
+TEST(Formatter,SizeHint)
+{
+	ASSERT_EQ(formatting::formatted_size("{}", order_id(123456)), 7u);
+	const formatting::compiled_format<1> line("order {}");
+	ASSERT_EQ(line(order_id(7)), "order #7");
+}
+#endif
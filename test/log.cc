@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+// trace statements are compiled out in this test
+#define FMTG_LOG_MIN_LEVEL 1
+#include <formatting/log.hpp>
+#include <string>
+
+#ifdef FMTG_USE_CXX11
+
+namespace
+{
+	std::string logged;
+	int evaluated = 0;
+
+	void collect(formatting::log_level, const char* line, std::size_t length)
+	{
+		logged.append(line, length);
+	}
+	int expensive()
+	{
+		return ++evaluated;
+	}
+	formatting::log_level expensiveLevel()
+	{
+		++evaluated;
+		return formatting::warning_level;
+	}
+	/** Logs while it is being formatted if it is outer. */
+	struct chatty
+	{
+		bool outer_;
+	};
+}
+namespace formatting
+{
+	template <>
+	struct formatter<chatty>
+	{
+		void operator()(buffer& out, const chatty& value) const
+		{
+			if (value.outer_)
+				FMTG_ERROR("nested {} {}", chatty{false}, 1);
+			out.append(std::string(value.outer_ ? "outer" : "inner"));
+		}
+		std::size_t size_hint(const chatty&) const
+		{
+			return 5;
+		}
+	};
+}
+namespace
+{
+
+	struct LogTest : public ::testing::Test
+	{
+		void SetUp()
+		{
+			logged.clear();
+			evaluated = 0;
+			formatting::set_log_writer(&collect);
+		}
+		void TearDown()
+		{
+			formatting::set_log_level(formatting::info_level);
+		}
+	};
+}
+
+TEST_F(LogTest,Enabled)
+{
+	formatting::set_log_level(formatting::debug_level);
+	FMTG_LOG_IF(formatting::debug_level, "{} items", expensive());
+	FMTG_WARNING("{} is {}", "x", 42);
+	ASSERT_EQ(logged, "1 items\nx is 42\n");
+	ASSERT_EQ(evaluated, 1);
+}
+TEST_F(LogTest,NoArguments)
+{
+	FMTG_INFO("starting");
+	FMTG_DEBUG("skipped");
+	ASSERT_EQ(logged, "starting\n");
+}
+TEST_F(LogTest,DisabledSkipsArguments)
+{
+	formatting::set_log_level(formatting::warning_level);
+	FMTG_LOG_IF(formatting::info_level, "{}", expensive());
+	FMTG_DEBUG("{}", expensive());
+	FMTG_INFO("{}", expensive());
+	ASSERT_EQ(logged, "");
+	ASSERT_EQ(evaluated, 0);
+	formatting::set_log_level(formatting::off_level);
+	FMTG_ERROR("{}", expensive());
+	ASSERT_EQ(evaluated, 0);
+	ASSERT_EQ(formatting::get_log_level(), formatting::off_level);
+}
+TEST_F(LogTest,CompiledOut)
+{
+	formatting::set_log_level(formatting::trace_level);
+	FMTG_TRACE("{}", expensive());
+	FMTG_LOG_IF(formatting::trace_level, "{}", expensive());
+	ASSERT_EQ(logged, "");
+	ASSERT_EQ(evaluated, 0);
+	ASSERT_TRUE(formatting::log_enabled(formatting::trace_level));
+}
+TEST_F(LogTest,LevelEvaluatedOnce)
+{
+	FMTG_LOG_IF(expensiveLevel(), "{}", "once");
+	ASSERT_EQ(logged, "once\n");
+	ASSERT_EQ(evaluated, 1);
+}
+TEST_F(LogTest,NestedStatement)
+{
+	FMTG_ERROR("before {} and {}", chatty{true}, 2);
+	ASSERT_EQ(logged, "nested inner 1\nbefore outer and 2\n");
+}
+TEST_F(LogTest,ErrorsAreMarked)
+{
+	FMTG_ERROR("{} {}", 1);
+	ASSERT_EQ(logged, "1 {!missing argument}\n");
+}
+TEST_F(LogTest,SingleStatement)
+{
+	formatting::set_log_level(formatting::error_level);
+	if (evaluated == 0)
+		FMTG_ERROR("{}", "yes");
+	else
+		FMTG_ERROR("{}", "no");
+	ASSERT_EQ(logged, "yes\n");
+}
+#endif
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+
+#ifdef FMTG_USE_CXX11
+TEST(MemoryBuffer,Inline)
+{
+	formatting::basic_memory_buffer<32> buffer;
+	ASSERT_NO_THROW(formatting::format_to(buffer, "hey {} howdy {}", 1, "mister"));
+	ASSERT_EQ(buffer.capacity(), 32u);
+	ASSERT_EQ(buffer.str(), "hey 1 howdy mister");
+	ASSERT_STREQ(buffer.c_str(), "hey 1 howdy mister");
+}
+TEST(MemoryBuffer,Spill)
+{
+	formatting::basic_memory_buffer<8> buffer;
+	const std::string long_string(1000, 'x');
+	ASSERT_NO_THROW(formatting::format_to(buffer, "{} {}", long_string, 42));
+	ASSERT_EQ(buffer.str(), long_string + " 42");
+}
+TEST(MemoryBuffer,Append)
+{
+	formatting::memory_buffer buffer;
+	formatting::format_to(buffer, "{}", 1);
+	formatting::format_to(buffer, " {}", 2);
+	ASSERT_EQ(buffer.str(), "1 2");
+}
+TEST(MemoryBuffer,ClearKeepsStorage)
+{
+	formatting::basic_memory_buffer<4> buffer;
+	formatting::format_to(buffer, "{} {}", "mister", 42);
+	const char* data = buffer.data();
+	const std::size_t capacity = buffer.capacity();
+	buffer.clear();
+	formatting::format_to(buffer, "{}", 7);
+	ASSERT_EQ(buffer.data(), data);
+	ASSERT_EQ(buffer.capacity(), capacity);
+	ASSERT_EQ(buffer.str(), "7");
+}
+TEST(MemoryBuffer,Compiled)
+{
+	static const formatting::compiled_format<2> line("{} is {}");
+	formatting::memory_buffer buffer;
+	line.format_to(buffer, "x", 42);
+	ASSERT_EQ(buffer.str(), "x is 42");
+}
+TEST(MemoryBuffer,Static)
+{
+	formatting::memory_buffer buffer;
+	FMTG_FORMAT("{} is {}").format_to(buffer, "x", 42);
+	ASSERT_EQ(buffer.str(), "x is 42");
+}
+#endif
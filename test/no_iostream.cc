@@ -0,0 +1,60 @@
+#define FMTG_NO_IOSTREAM
+#include <formatting/formatting.hpp>
+#include <gtest/gtest.h>
+#include <ostream>
+#include <locale>
+#include <string>
+#include <vector>
+
+using formatting::width;
+using formatting::precision;
+
+struct point
+{
+	int x, y;
+};
+
+std::ostream& operator<<(std::ostream& out, const point& p)
+{
+	return out << "point(" << p.x << ", " << p.y << ")";
+}
+
+/** Numpunct that separates thousands and uses the decimal comma. */
+struct comma_numpunct : std::numpunct<char>
+{
+	char do_decimal_point() const { return ','; }
+	char do_thousands_sep() const { return '.'; }
+	std::string do_grouping() const { return "\3"; }
+};
+
+TEST(NoIostream,BuiltIn)
+{
+	std::string result;
+	int value = 1234567;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {} {} {}", 'c', value, &value, 2.5, true, 
+		std::vector<long double>(1, 0.25L)));
+	ASSERT_STREQ(result.c_str(),"c 1234567 1234567 2.5 true [0.25]");
+}
+
+TEST(NoIostream,Wrappers)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {}", width[8](formatting::hex(255), '_'),
+		formatting::oct(8), precision[3](3.14159L)));
+	ASSERT_STREQ(result.c_str(),"____0xFF 010 3.14");
+}
+
+TEST(NoIostream,UserType)
+{
+	point p = {1, 2};
+	ASSERT_EQ(formatting::format("{}", p), "point(1, 2)");
+}
+
+TEST(NoIostream,LocaleInvariant)
+{
+	const std::locale global = std::locale::global(std::locale(std::locale::classic(), new comma_numpunct));
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {}", 1234567, 0.5));
+	std::locale::global(global);
+	ASSERT_STREQ(result.c_str(),"1234567 0.5");
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <iterator>
+#include <string>
+
+using formatting::arg;
+
+/** Counts conversions to check that repeated arguments are converted once. */
+struct counted
+{
+	counted() : conversions(0) { }
+	mutable int conversions;
+};
+
+namespace formatting
+{
+	template <>
+	struct formatter<counted>
+	{
+		void operator()(buffer& out, const counted& value) const
+		{
+			value.conversions++;
+			out.append("counted", "counted" + 7);
+		}
+		std::size_t size_hint(const counted&) const
+		{
+			return 7;
+		}
+	};
+}
+
+#ifdef FMTG_USE_CXX11
+TEST(Positional,Reorder)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{1} {0} {1}", "hey", 42));
+	ASSERT_STREQ(result.c_str(),"42 hey 42");
+}
+TEST(Positional,Named)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{who} is {age}, {who}!", arg("age", 42), arg("who", "mister")));
+	ASSERT_STREQ(result.c_str(),"mister is 42, mister!");
+}
+TEST(Positional,Mixed)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {name} {}", 1, arg("name", 2)));
+	ASSERT_STREQ(result.c_str(),"1 2 2");
+	ASSERT_NO_THROW(result = formatting::format("{1} {name} {0}", 1, arg("name", 2)));
+	ASSERT_STREQ(result.c_str(),"2 2 1");
+}
+TEST(Positional,MixedIndexing)
+{
+	ASSERT_THROW(formatting::format("{} {0}", 1), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{1} {}", 1, 2), formatting::formatting_error);
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{} {0} {}", 1, 2), "1 {!mixed indexing} 2");
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{0} {} {1}", 1, 2), "1 {!mixed indexing} 2");
+	std::string result;
+	ASSERT_EQ(formatting::try_format(result, "{} {0}", 1), formatting::mixed_indexing);
+	ASSERT_THROW(formatting::compiled_format<2>("{} {1}"), formatting::formatting_error);
+}
+TEST(Positional,NotFields)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{\"key\": {}, {0 }, {-1} }", 1));
+	ASSERT_STREQ(result.c_str(),"{\"key\": 1, {0 }, {-1} }");
+}
+TEST(Positional,Errors)
+{
+	ASSERT_THROW(formatting::format("{2}", 1, 2), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{nobody}", arg("who", 1)), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{18446744073709551616}", 1), formatting::formatting_error);
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{0} {99999999999999999999999}", 1), 
+	          "1 {!index out of range}");
+	ASSERT_THROW(formatting::compiled_format<1>("{18446744073709551617}"), formatting::formatting_error);
+}
+TEST(Positional,ConvertedOnce)
+{
+	const counted value;
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{0} {0} {0}", value));
+	ASSERT_STREQ(result.c_str(),"counted counted counted");
+	ASSERT_EQ(value.conversions, 1);
+}
+TEST(Positional,ConvertedOnceWithSpecs)
+{
+	const counted value;
+	ASSERT_EQ(formatting::format("{0:>9}|{0:<8}|{0}|{0:^9}", value), "  counted|counted |counted| counted ");
+	ASSERT_EQ(value.conversions, 1);
+	const counted other;
+	ASSERT_EQ(formatting::compiled_format<1>("{0}|{0:*>8}")(other), "counted|*counted");
+	ASSERT_EQ(FMTG_FORMAT("{0:>8}{0}{1:x}{1:x}")(other, 255), " countedcountedffff");
+	ASSERT_EQ(other.conversions, 2);
+}
+TEST(Positional,ConvertedAgainWhenFlushed)
+{
+	const counted value;
+	const std::string padding(1000, '.');
+	std::string result;
+	formatting::format_to(std::back_inserter(result), "{0}{1}{0}", value, padding);
+	ASSERT_EQ(result, "counted" + padding + "counted");
+	ASSERT_EQ(value.conversions, 2);
+}
+TEST(Positional,Compiled)
+{
+	const counted value;
+	static const formatting::compiled_format<2> line("{who}: {0} {0} {who}");
+	ASSERT_EQ(line(value, arg("who", "me")), "me: counted counted me");
+	ASSERT_EQ(value.conversions, 1);
+	ASSERT_THROW(formatting::compiled_format<1>("{0} {1}"), formatting::formatting_error);
+}
+TEST(Positional,Static)
+{
+	const counted value;
+	const auto line = FMTG_FORMAT("{1} {0} {1} {0}");
+	static_assert(decltype(line)::n_placeholders == 4, "");
+	static_assert(decltype(line)::n_arguments == 2, "");
+	ASSERT_EQ(line(value, 42), "42 counted 42 counted");
+	ASSERT_EQ(value.conversions, 1);
+}
+#endif
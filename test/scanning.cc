@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+
+namespace
+{
+	const char* naiveBrace(const char* p, const char* end)
+	{
+		while (p != end && *p != '{' && *p != '}')
+			++p;
+		return p;
+	}
+
+	/** Checks the search from every start in texts with one brace
+	 * at every position, so that braces fall on all lanes and 
+	 * across the boundaries of steps. */
+	template <typename Find>
+	void expectFound(Find find)
+	{
+		const std::string filler(300, 'y');
+		for (std::size_t position=0; position<filler.size(); position++)
+		{
+			for (int brace=0; brace<2; brace++)
+			{
+				std::string text = filler;
+				text[position] = brace ? '}' : '{';
+				const char* begin = text.data();
+				const char* end = begin + text.size();
+				for (std::size_t start=0; start<=text.size(); start+=7)
+					ASSERT_EQ(find(begin + start, end), naiveBrace(begin + start, end)) 
+						<< "position " << position << " start " << start;
+				ASSERT_EQ(find(begin, begin + position), begin + position);
+			}
+		}
+		ASSERT_EQ(find(filler.data(), filler.data() + filler.size()), filler.data() + filler.size());
+	}
+}
+
+TEST(Scanning,Portable)
+{
+	expectFound(&formatting::internal::findBraceScalar);
+}
+TEST(Scanning,Default)
+{
+	expectFound(&formatting::internal::findBrace);
+}
+#if defined(FMTG_SIMD_SSE2) || defined(FMTG_SIMD_AVX2)
+TEST(Scanning,Sse2)
+{
+	expectFound(&formatting::internal::findBraceSse2);
+}
+#endif
+#if defined(FMTG_SIMD_AVX2) || defined(FMTG_SIMD_AVX2_DISPATCH)
+TEST(Scanning,Avx2)
+{
+#ifdef FMTG_SIMD_AVX2_DISPATCH
+	if (!formatting::internal::hasAvx2())
+		return;
+#endif
+	expectFound(&formatting::internal::findBraceAvx2);
+}
+#endif
+TEST(Scanning,LongTemplates)
+{
+	for (std::size_t length=0; length<200; length+=13)
+	{
+		const std::string text(length, 'x');
+		const std::string fmt = text + "{}" + text + "{{" + text + "}}" + text + "{:>3}" + text;
+		const std::string expected = text + "1" + text + "{" + text + "}" + text + "  2" + text;
+		ASSERT_EQ(formatting::format(fmt, 1, 2), expected);
+		const formatting::compiled_format<2> compiled(fmt);
+		ASSERT_EQ(compiled(1, 2), expected);
+	}
+}
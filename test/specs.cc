@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+using formatting::arg;
+
+/** Counts conversions to check that padded values are converted once. */
+struct counted
+{
+	counted() : conversions(0) { }
+	mutable int conversions;
+};
+
+namespace formatting
+{
+	template <>
+	struct formatter<counted>
+	{
+		void operator()(buffer& out, const counted& value) const
+		{
+			value.conversions++;
+			out.append("ab", "ab" + 2);
+		}
+		std::size_t size_hint(const counted&) const
+		{
+			return 2;
+		}
+	};
+}
+
+#ifdef FMTG_USE_CXX11
+TEST(Specs,Integers)
+{
+	ASSERT_EQ(formatting::format("{:08x}", 48879), "0000beef");
+	ASSERT_EQ(formatting::format("{:#X}", 48879), "0XBEEF");
+	ASSERT_EQ(formatting::format("{:#b}", 5), "0b101");
+	ASSERT_EQ(formatting::format("{:o}", 8), "10");
+	ASSERT_EQ(formatting::format("{:+d}", 42), "+42");
+	ASSERT_EQ(formatting::format("{: d}", 42), " 42");
+	ASSERT_EQ(formatting::format("{:06}", -42), "-00042");
+	ASSERT_EQ(formatting::format("{:#010x}", 255), "0x000000ff");
+	ASSERT_EQ(formatting::format("{:x}", -255), "-ff");
+	ASSERT_EQ(formatting::format("{:x}", std::numeric_limits<long long>::min()), "-8000000000000000");
+}
+TEST(Specs,Floating)
+{
+	ASSERT_EQ(formatting::format("{:.3f}", 3.14159), "3.142");
+	ASSERT_EQ(formatting::format("{:.2f}", 2.675), "2.67");
+	ASSERT_EQ(formatting::format("{:.0f}", 2.5), "2");
+	ASSERT_EQ(formatting::format("{:f}", 1.5), "1.500000");
+	ASSERT_EQ(formatting::format("{:.2f}", 1e21), "1000000000000000000000.00");
+	ASSERT_EQ(formatting::format("{:.3f}", 0.0004), "0.000");
+	ASSERT_EQ(formatting::format("{:.3f}", 0.0005001), "0.001");
+	ASSERT_EQ(formatting::format("{:.2e}", 12345.678), "1.23e+04");
+	ASSERT_EQ(formatting::format("{:E}", 0.0), "0.000000E+00");
+	ASSERT_EQ(formatting::format("{:g}", 1234567.0), "1.23457e+06");
+	ASSERT_EQ(formatting::format("{:.3}", 3.14159), "3.14");
+	ASSERT_EQ(formatting::format("{:+.1f}", 2.0), "+2.0");
+	ASSERT_EQ(formatting::format("{:08.2f}", -3.14159), "-0003.14");
+	ASSERT_EQ(formatting::format("{:F}", std::numeric_limits<double>::infinity()), "INF");
+	ASSERT_EQ(formatting::format("{:.1f}", 3), "3.0");
+}
+TEST(Specs,FixedTiny)
+{
+	const double values[] = {5e-324, 1e-320, 2.2250738585072014e-308, 1e-300};
+	const int precisions[] = {770, 800, 1074, 1100};
+	for (std::size_t i=0; i<sizeof(values)/sizeof(values[0]); i++)
+	{
+		for (std::size_t j=0; j<sizeof(precisions)/sizeof(precisions[0]); j++)
+		{
+			char expected[1200];
+			std::snprintf(expected, sizeof(expected), "%.*f", precisions[j], values[i]);
+			ASSERT_EQ(formatting::format("{:." + std::to_string(precisions[j]) + "f}", values[i]), expected);
+		}
+	}
+}
+TEST(Specs,FloatingSpecial)
+{
+	const double inf = std::numeric_limits<double>::infinity();
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	ASSERT_EQ(formatting::format("{:08f}", -inf), "    -inf");
+	ASSERT_EQ(formatting::format("{:08}", inf), "     inf");
+	ASSERT_EQ(formatting::format("{:+08.2f}", nan), "    +nan");
+	ASSERT_EQ(formatting::format("{:*<6}", -inf), "-inf**");
+	ASSERT_EQ(formatting::format("{:+}", nan), "+nan");
+	ASSERT_EQ(formatting::format("{: }", nan), " nan");
+	ASSERT_EQ(formatting::format("{:+}", -inf), "-inf");
+}
+TEST(Specs,Alignment)
+{
+	ASSERT_EQ(formatting::format("[{:>6}]", 42), "[    42]");
+	ASSERT_EQ(formatting::format("[{:<6}]", 42), "[42    ]");
+	ASSERT_EQ(formatting::format("[{:^6}]", 42), "[  42  ]");
+	ASSERT_EQ(formatting::format("[{:*^7}]", "ab"), "[**ab***]");
+	ASSERT_EQ(formatting::format("[{:6}]", "ab"), "[ab    ]");
+	ASSERT_EQ(formatting::format("[{:6}]", 1.5), "[   1.5]");
+	ASSERT_EQ(formatting::format("[{:2}]", "abcd"), "[abcd]");
+	ASSERT_EQ(formatting::format("[{:>12}]", std::vector<int>{1, 2}), "[      [1, 2]]");
+	ASSERT_EQ(formatting::format("[{:5}]", true), "[true ]");
+}
+TEST(Specs,PaddedOnce)
+{
+	const counted value;
+	ASSERT_EQ(formatting::format("[{:>4}]", value), "[  ab]");
+	ASSERT_EQ(value.conversions, 1);
+}
+TEST(Specs,Strings)
+{
+	ASSERT_EQ(formatting::format("{:.3}", "abcdef"), "abc");
+	ASSERT_EQ(formatting::format("{:>5.2}", std::string("abcdef")), "   ab");
+	ASSERT_EQ(formatting::format("{:s}", "abc"), "abc");
+}
+TEST(Specs,ZeroFlagOfNumbersOnly)
+{
+	ASSERT_EQ(formatting::format("{:08}", "abc"), "abc     ");
+	ASSERT_EQ(formatting::format("{:>08}", std::string("abc")), "     abc");
+	ASSERT_EQ(formatting::format("{:*<08}", "abc"), "abc*****");
+	ASSERT_EQ(formatting::format("{:06}", true), "true  ");
+	ASSERT_EQ(formatting::format("{:06}|{:06}", -7, 1.5), "-00007|0001.5");
+	ASSERT_EQ(FMTG_FORMAT("{:06}|{:06}")("ab", 7), "ab    |000007");
+}
+TEST(Specs,PositionalAndNamed)
+{
+	ASSERT_EQ(formatting::format("{0:x} {0} {0:>4}", 255), "ff 255  255");
+	ASSERT_EQ(formatting::format("{price:.2f}", arg("price", 9.999)), "10.00");
+}
+TEST(Specs,Invalid)
+{
+	ASSERT_THROW(formatting::format("{:.} {}", 1, 2), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{:c}", 1.5), formatting::formatting_error);
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{:.} {}", 1, 2), "{!invalid spec} 2");
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{0:q}|{0}", 1), "{!invalid spec}|1");
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{:5x!}", 1), "{!invalid spec}");
+	ASSERT_THROW(formatting::compiled_format<1>("{:c}"), formatting::formatting_error);
+	// presentation types of other types
+	ASSERT_THROW(formatting::format("{:d}", 2.5), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{:x}", "str"), formatting::formatting_error);
+	ASSERT_THROW(formatting::format("{:.2f}", std::string("str")), formatting::formatting_error);
+	ASSERT_EQ(formatting::format<formatting::mark_errors>("{:b}|{:e}", 1.5, "a"),
+	          "{!invalid spec}|{!invalid spec}");
+	ASSERT_THROW(formatting::compiled_format<1>("{:o}")(0.5f), formatting::formatting_error);
+	ASSERT_EQ(formatting::format("{:x}|{:e}", 255, 1), "ff|1.000000e+00");
+	ASSERT_THROW(formatting::compiled_format<2>("{} {:q}"), formatting::formatting_error);
+	// braces that can't be a field stay literal text
+	ASSERT_EQ(formatting::format("{:q {}", 1), "{:q 1");
+	ASSERT_EQ(formatting::format("{:q {} }", 1), "{:q 1 }");
+}
+TEST(Specs,Compiled)
+{
+	const formatting::compiled_format<2> line("{:>5}|{:.1f}");
+	ASSERT_EQ(line(7, 0.25), "    7|0.2");
+	ASSERT_EQ(line("ab", 1.25), "   ab|1.2");
+}
+TEST(Specs,Static)
+{
+	ASSERT_EQ(FMTG_FORMAT("{:08x}|{:<4}|{:.3f}")(48879, "ab", 3.14159), "0000beef|ab  |3.142");
+	ASSERT_EQ(FMTG_FORMAT("{0:*^5}{0}{0}")(1), "**1**11");
+	ASSERT_EQ(FMTG_FORMAT("{:+#o}")(8), "+0o10");
+}
+#endif
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <formatting/formatting.hpp>
+#include <string>
+
+TEST(StaticFormat,Apply)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = FMTG_FORMAT("{} + {} is {} and that's {}")(2, 2, 4, true));
+	ASSERT_STREQ(result.c_str(),"2 + 2 is 4 and that's true");
+}
+TEST(StaticFormat,Types)
+{
+	std::string result;
+	std::vector<int> vec;
+	vec.push_back(10);
+	vec.push_back(101);
+	ASSERT_NO_THROW(result = FMTG_FORMAT("hey {}{} {} {} howdy")('c', "3", std::string("mister"), vec));
+	ASSERT_STREQ(result.c_str(),"hey c3 mister [10, 101] howdy");
+}
+TEST(StaticFormat,NoPlaceholders)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = FMTG_FORMAT("hey howdy")());
+	ASSERT_STREQ(result.c_str(),"hey howdy");
+	ASSERT_NO_THROW(result = FMTG_FORMAT("")());
+	ASSERT_STREQ(result.c_str(),"");
+}
+TEST(StaticFormat,NumberOfPlaceholders)
+{
+	const auto one = FMTG_FORMAT("{}");
+	const auto three = FMTG_FORMAT("{}{}{{}}{}");
+	const auto none = FMTG_FORMAT("{ } }{");
+	static_assert(decltype(one)::n_placeholders == 1, "");
+	static_assert(decltype(three)::n_placeholders == 3, "");
+	static_assert(decltype(none)::n_placeholders == 0, "");
+}
+TEST(StaticFormat,ManyPlaceholders)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = FMTG_FORMAT("{}{}{}{}{}{}{}{}{}{} {}{}{}{}{}{}{}{}{}{} {}{}{}{}{}{}{}{}{}{} {}{}{}{}{}{}{}{}{}{}")(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+	ASSERT_STREQ(result.c_str(),"0123456789 0123456789 0123456789 0123456789");
+}
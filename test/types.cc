@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include <formatting/formatting.hpp>
 #include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <set>
+#include <map>
 
 TEST(Types,Char)
 {
@@ -20,6 +25,17 @@ TEST(Types,UnsignedChar)
 	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", static_cast<unsigned char>('+')));
 	ASSERT_STREQ(result.c_str(),"hey + howdy");
 }
+TEST(Types,WideChar)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{}", L'a'));
+	ASSERT_STREQ(result.c_str(),"97");
+	ASSERT_EQ(formatting::format("{:x}", L'a'), "61");
+#ifdef FMTG_USE_CXX11
+	ASSERT_EQ(formatting::format("{} {}", u'b', U'c'), "98 99");
+	ASSERT_EQ(formatting::format("{:x}", U'\U0001F600'), "1f600");
+#endif
+}
 TEST(Types,Short)
 {
 	std::string result;
@@ -56,6 +72,37 @@ TEST(Types,UnsignedLong)
 	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", static_cast<unsigned long>(4294967290)));
 	ASSERT_STREQ(result.c_str(),"hey 4294967290 howdy");
 }
+TEST(Types,LongLong)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", static_cast<long long>(-9000000000LL)));
+	ASSERT_STREQ(result.c_str(),"hey -9000000000 howdy");
+}
+TEST(Types,UnsignedLongLong)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", static_cast<unsigned long long>(18446744073709551615ULL)));
+	ASSERT_STREQ(result.c_str(),"hey 18446744073709551615 howdy");
+}
+TEST(Types,IntegerLimits)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {}", std::numeric_limits<short>::min(),
+		std::numeric_limits<int>::min(), std::numeric_limits<long long>::min(), 0));
+	ASSERT_STREQ(result.c_str(),"-32768 -2147483648 -9223372036854775808 0");
+}
+TEST(Types,IntegerDigits)
+{
+	for (unsigned long long power = 1; power < 10000000000000000000ULL; power *= 10)
+	{
+		for (unsigned long long value = power - 1; value <= power + 1; value++)
+		{
+			std::stringstream expected;
+			expected << value;
+			ASSERT_STREQ(formatting::format("{}", value).c_str(), expected.str().c_str());
+		}
+	}
+}
 TEST(Types,Float)
 {
 	std::string result;
@@ -68,12 +115,73 @@ TEST(Types,Double)
 	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", formatting::precision[9](static_cast<double>(3.14159265))));
 	ASSERT_STREQ(result.c_str(),"hey 3.14159265 howdy");
 }
+TEST(Types,FloatShortest)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} {} {} howdy", 2.123456f, 0.1f, 3.0f));
+	ASSERT_STREQ(result.c_str(),"hey 2.123456 0.1 3 howdy");
+}
+TEST(Types,DoubleShortest)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} {} {} {} howdy", 0.1, 3.14159265, -1e100, 1.7976931348623157e308));
+	ASSERT_STREQ(result.c_str(),"hey 0.1 3.14159265 -1e+100 1.7976931348623157e+308 howdy");
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {}", 5e-324, 0.0001, 0.00001, 123456789012345.0));
+	ASSERT_STREQ(result.c_str(),"5e-324 0.0001 1e-05 123456789012345");
+}
+TEST(Types,DoubleSpecial)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {}", 0.0, -0.0, 
+		std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()));
+	ASSERT_STREQ(result.c_str(),"0 -0 inf -inf");
+	ASSERT_NO_THROW(result = formatting::format("{}", std::numeric_limits<double>::quiet_NaN()));
+	ASSERT_STREQ(result.c_str(),"nan");
+}
+TEST(Types,DoubleRoundTrip)
+{
+	double value = 1.0;
+	for (int i=0; i<1000; i++)
+	{
+		value = value * 1.7 + 0.3;
+		if (value > 1e300)
+			value = 1e-300;
+		std::stringstream parsed(formatting::format("{}", value));
+		double parsed_value = 0.0;
+		parsed >> parsed_value;
+		ASSERT_EQ(parsed_value, value);
+	}
+}
 TEST(Types,String)
 {
 	std::string result;
 	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", static_cast<std::string>("mister")));
 	ASSERT_STREQ(result.c_str(),"hey mister howdy");
 }
+TEST(Types,LargeString)
+{
+	const std::string payload(100000, 'x');
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("<{}>", payload));
+	ASSERT_EQ(result, "<" + payload + ">");
+}
+TEST(Types,CharPointer)
+{
+	char mister[] = "mister";
+	char* pointer = mister;
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} {} howdy", pointer, mister));
+	ASSERT_STREQ(result.c_str(),"hey mister mister howdy");
+}
+#ifdef FMTG_USE_CXX17
+TEST(Types,StringView)
+{
+	const std::string_view view = std::string_view("hey mister").substr(4);
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", view));
+	ASSERT_STREQ(result.c_str(),"hey mister howdy");
+}
+#endif
 TEST(Types,Bool)
 {
 	std::string result;
@@ -97,3 +205,60 @@ TEST(Types,Vector)
 	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", static_cast< std::vector<int> >(vec)));
 	ASSERT_STREQ(result.c_str(),"hey [10, 101, 99] howdy");
 }
+TEST(Types,EmptyVector)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", std::vector<int>()));
+	ASSERT_STREQ(result.c_str(),"hey [] howdy");
+}
+TEST(Types,NestedVector)
+{
+	std::vector< std::vector<double> > vec(2);
+	vec[0].push_back(0.5);
+	vec[0].push_back(1e100);
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{}", vec));
+	ASSERT_STREQ(result.c_str(),"[[0.5, 1e+100], []]");
+}
+TEST(Types,LongVector)
+{
+	std::vector<int> vec;
+	std::stringstream expected;
+	expected << "[";
+	for (int i=0; i<5000; i++)
+	{
+		vec.push_back(i * 7919 - 20000);
+		expected << (i ? ", " : "") << vec.back();
+	}
+	expected << "]";
+	ASSERT_EQ(formatting::format("{}", vec), expected.str());
+}
+TEST(Types,Containers)
+{
+	std::deque<std::string> deque;
+	deque.push_back("hey");
+	deque.push_back("mister");
+	std::list<char> list;
+	list.push_back('a');
+	std::set<int> set;
+	set.insert(3);
+	set.insert(1);
+	std::map<std::string, int> map;
+	map["one"] = 1;
+	map["two"] = 2;
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {} {}", deque, list, set, map, std::make_pair(1, "x")));
+	ASSERT_STREQ(result.c_str(),"[hey, mister] [a] {1, 3} {one: 1, two: 2} (1, x)");
+}
+#ifdef FMTG_USE_CXX11
+TEST(Types,ContainersCXX11)
+{
+	const std::array<int, 3> array = {{1, 2, 3}};
+	std::unordered_map<int, bool> map;
+	map[42] = true;
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {}", array, map, 
+		std::make_tuple(1, 2.5, std::string("x")), std::tuple<>()));
+	ASSERT_STREQ(result.c_str(),"[1, 2, 3] {42: true} (1, 2.5, x) ()");
+}
+#endif
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <formatting/formatting.hpp>
 #include <string>
+#include <vector>
+#include <map>
 
 TEST(Wrappers,Hex)
 {
@@ -45,3 +47,92 @@ TEST(Wrappers,Precision)
 	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", formatting::precision[6](2.718281828)));
 	ASSERT_STREQ(result.c_str(),"hey 2.71828 howdy");
 }
+
+TEST(Wrappers,PrecisionRounding)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {} {}", formatting::precision[2](0.125),
+		formatting::precision[2](0.375), formatting::precision[3](999.6), formatting::precision[1](0.05)));
+	ASSERT_STREQ(result.c_str(),"0.12 0.38 1e+03 0.05");
+}
+
+TEST(Wrappers,PrecisionLarge)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {}", formatting::precision[20](0.1), formatting::precision[17](1e22)));
+	ASSERT_STREQ(result.c_str(),"0.10000000000000000555 1e+22");
+}
+
+TEST(Wrappers,PrecisionInteger)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("hey {} howdy", formatting::precision[2](12345)));
+	ASSERT_STREQ(result.c_str(),"hey 12345 howdy");
+}
+
+TEST(Wrappers,HexLimits)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {}", formatting::hex(0), formatting::hex(-1),
+		formatting::hex(0xFFFFFFFFFFFFFFFFull)));
+	ASSERT_STREQ(result.c_str(),"0x0 0xFFFFFFFF 0xFFFFFFFFFFFFFFFF");
+}
+
+TEST(Wrappers,OctLimits)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {}", formatting::oct(0), formatting::oct(8)));
+	ASSERT_STREQ(result.c_str(),"00 010");
+}
+
+TEST(Wrappers,WidthHex)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("[{}]", formatting::width[12](formatting::hex(0xBEEF))));
+	ASSERT_STREQ(result.c_str(),"[      0xBEEF]");
+}
+
+TEST(Wrappers,WidthPrecision)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("[{}] [{}]", formatting::width[8](formatting::precision[3](3.14159),'*'),
+		formatting::width[2](12345)));
+	ASSERT_STREQ(result.c_str(),"[****3.14] [12345]");
+}
+
+TEST(Wrappers,Limit)
+{
+	std::vector<int> vec;
+	for (int i=0; i<1000000; i++)
+		vec.push_back(i);
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {}", formatting::limit[3](vec),
+		formatting::limit[0](vec), formatting::limit[5](std::vector<int>(2, 7))));
+	ASSERT_STREQ(result.c_str(),"[0, 1, 2, \xE2\x80\xA6 (999997 more)] [\xE2\x80\xA6 (1000000 more)] [7, 7]");
+}
+
+TEST(Wrappers,LimitMap)
+{
+	std::map<int, char> map;
+	map[1] = 'a';
+	map[2] = 'b';
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{}", formatting::limit[1](map)));
+	ASSERT_STREQ(result.c_str(),"{1: a, \xE2\x80\xA6 (1 more)}");
+}
+
+TEST(Wrappers,Truncate)
+{
+	const std::string payload(100000, 'x');
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{} {} {}", formatting::truncate[4](payload),
+		formatting::truncate[3]("mister"), formatting::truncate[10]("hey")));
+	ASSERT_STREQ(result.c_str(),"xxxx\xE2\x80\xA6 (99996 more) mis\xE2\x80\xA6 (3 more) hey");
+}
+
+TEST(Wrappers,TruncateUtf8)
+{
+	std::string result;
+	ASSERT_NO_THROW(result = formatting::format("{}", formatting::truncate[2]("a\xC3\xA9" "b")));
+	ASSERT_STREQ(result.c_str(),"a\xE2\x80\xA6 (3 more)");
+}